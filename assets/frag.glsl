@@ -3,14 +3,69 @@
 uniform sampler2D u_Texture;
 uniform vec4 u_Color;
 uniform bool u_Text = false;
+uniform bool u_SDF = false;
+
+uniform bool u_Grid = false;
+uniform float u_GridSpacing = 1.0;
+uniform float u_GridSubdivision = 10.0; // Count of lines of a level between two lines of the next level
+uniform float u_GridMinPixels = 8.0; // Minimum distance between two lines, in pixels
+uniform float u_GridThickness = 1.0; // Width of the lines, in pixels
+uniform vec4 u_GridColor;
+uniform vec4 u_GridAxisXColor;
+uniform vec4 u_GridAxisYColor;
 
 in vec4 color; // Global color
 in vec2 uv;
 
+in vec2 sdfPos;
+flat in vec4 sdfOutlineColor;
+flat in float sdfOutlineThickness;
+
+in vec2 gridPos;
+
 out vec4 out_Color;
 
+// Coverage of the lines of a spacing, anti-aliased over one pixel
+float gridLines(float spacing)
+{
+    vec2 coord = gridPos / spacing;
+
+    // Distance to the nearest line, in pixels
+    vec2 dist = abs(fract(coord + 0.5) - 0.5) / fwidth(coord);
+
+    return clamp(u_GridThickness * 0.5 + 0.5 - min(dist.x, dist.y), 0.0, 1.0);
+}
+
+// Color of the grid, with the smaller levels fading out when zooming out
+vec4 grid()
+{
+    // Size of a pixel in the space of the grid
+    float pixel = max(fwidth(gridPos.x), fwidth(gridPos.y));
+
+    // The smallest level where the lines are at least u_GridMinPixels apart, as a real number to fade between levels
+    float level = log(u_GridMinPixels * pixel / u_GridSpacing) / log(u_GridSubdivision);
+    float minor = u_GridSpacing * pow(u_GridSubdivision, floor(level) + 1.0);
+    float major = minor * u_GridSubdivision;
+
+    float coverage = max(gridLines(minor) * (1.0 - fract(level)), gridLines(major));
+    vec4 result = vec4(u_GridColor.rgb, u_GridColor.a * coverage);
+
+    // Axes over the lines
+    vec2 axis = clamp(u_GridThickness * 0.5 + 0.5 - abs(gridPos) / fwidth(gridPos), 0.0, 1.0);
+    result = mix(result, u_GridAxisYColor, axis.x * u_GridAxisYColor.a);
+    result = mix(result, u_GridAxisXColor, axis.y * u_GridAxisXColor.a);
+
+    return result;
+}
+
 void main()
 {
+    if(u_Grid)
+    {
+        out_Color = grid();
+        return;
+    }
+
     // 1 if text is rendered, 0 otherwise
     float isText = float(u_Text);
 
@@ -18,4 +73,26 @@ void main()
     textureColor = mix(texture(u_Texture, uv), vec4(vec3(1.0), texture(u_Texture, uv).r), isText);
 
     out_Color = u_Color * color * textureColor;
+
+    if(u_SDF)
+    {
+        // Circle of radius 1, the outline is outside if the thickness is positive and inside otherwise
+        float dist = length(sdfPos);
+        float inner = 1.0 + min(sdfOutlineThickness, 0.0);
+        float outer = 1.0 + max(sdfOutlineThickness, 0.0);
+
+        // Size of a pixel in local space, to anti-alias the borders over one pixel
+        float pixel = fwidth(dist);
+
+        float outline = sdfOutlineThickness != 0.0 ? clamp((dist - inner) / pixel + 0.5, 0.0, 1.0) : 0.0;
+        float coverage = clamp((outer - dist) / pixel + 0.5, 0.0, 1.0);
+
+        out_Color = mix(out_Color, sdfOutlineColor, outline);
+        out_Color.a *= coverage;
+
+        if(out_Color.a <= 0.0)
+        {
+            discard;
+        }
+    }
 }
\ No newline at end of file
@@ -4,18 +4,82 @@ uniform mat4 u_ModelMatrix;
 uniform mat4 u_ViewMatrix;
 uniform sampler2D u_Texture;
 
+// Instanced rendering (ShapeInstances), the instance attributes are only read when enabled
+uniform bool u_Instanced = false;
+uniform bool u_InstancedOutline = false; // If the outline is drawn, otherwise the fill
+
+// SDF circles (Circle::Mode::SDF), the geometry is a quad [-1, 1]² and the circle has a radius of 1
+uniform bool u_SDF = false;
+uniform vec4 u_OutlineColor = vec4(1.0);
+uniform float u_OutlineThickness = 0.0;
+
+// Procedural grid (Grid), the geometry is a quad covering the whole screen
+uniform bool u_Grid = false;
+
 layout (location = 0) in vec2 in_Pos;
 layout (location = 1) in vec4 in_Color;
 layout (location = 2) in vec2 in_UV;
 
+layout (location = 3) in mat4 in_InstanceModel; // Takes locations 3 to 6
+layout (location = 7) in vec4 in_InstanceColor;
+layout (location = 8) in vec4 in_InstanceOutlineColor;
+layout (location = 9) in float in_InstanceOutlineThickness;
+layout (location = 10) in vec2 in_OutlineOffset; // Offset of the outline vertex for a thickness of 1
+
 out vec4 color;
 out vec2 uv;
 
+out vec2 sdfPos; // Position in the local space of the circle
+flat out vec4 sdfOutlineColor;
+flat out float sdfOutlineThickness;
+
+out vec2 gridPos; // Position in the space of the grid
+
 void main()
 {
-    vec4 pos = vec4(in_Pos.x, in_Pos.y, 0.0, 1.0);
-    gl_Position = u_ViewMatrix * u_ModelMatrix * pos;
+    vec2 localPos = in_Pos;
+    mat4 model = u_ModelMatrix;
 
     color = in_Color;
+
+    sdfOutlineColor = u_OutlineColor;
+    sdfOutlineThickness = u_OutlineThickness;
+
+    if(u_Instanced)
+    {
+        model = u_ModelMatrix * in_InstanceModel;
+
+        if(u_InstancedOutline)
+        {
+            localPos += in_OutlineOffset * in_InstanceOutlineThickness;
+            color *= in_InstanceOutlineColor;
+        }
+        else
+        {
+            color *= in_InstanceColor;
+        }
+
+        sdfOutlineColor = in_InstanceOutlineColor;
+        sdfOutlineThickness = in_InstanceOutlineThickness;
+    }
+
+    if(u_SDF)
+    {
+        // Grow the quad to also cover the outline
+        localPos *= 1.0 + max(sdfOutlineThickness, 0.0);
+    }
+
+    sdfPos = localPos;
+
+    vec4 pos = vec4(localPos.x, localPos.y, 0.0, 1.0);
+    gl_Position = u_ViewMatrix * model * pos;
+
     uv = in_UV;
+
+    if(u_Grid)
+    {
+        // The quad is already in clip space, the grid is behind it
+        gl_Position = vec4(in_Pos, 0.0, 1.0);
+        gridPos = (inverse(u_ViewMatrix * u_ModelMatrix) * gl_Position).xy;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,219 @@
+#include "RenderThread.hpp"
+#include <iostream>
+#include <utility>
+
+void FrameTimer::presented(Time start)
+{
+    const Time now = Time::now();
+
+    std::lock_guard lock(m_mutex);
+
+    if(m_first)
+    {
+        m_first = false;
+        m_latency = now - start;
+    }
+    else
+    {
+        m_latency += ((now - start) - m_latency) * smoothing;
+        m_frameTime += ((now - m_lastPresentation) - m_frameTime) * smoothing;
+    }
+
+    m_lastPresentation = now;
+}
+
+Time FrameTimer::getLatency() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_latency;
+}
+
+Time FrameTimer::getFrameTime() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_frameTime;
+}
+
+void FrameTimer::reset()
+{
+    std::lock_guard lock(m_mutex);
+
+    m_latency = {};
+    m_frameTime = {};
+    m_first = true;
+}
+
+RenderThread::RenderThread(Window& window)
+    : m_window(window)
+{
+    // The context can only be current on one thread at a time
+    m_window.setActive(false);
+    m_thread = std::thread(&RenderThread::run, this);
+}
+
+RenderThread::~RenderThread()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+
+    m_condition.notify_all();
+    m_thread.join();
+
+    // Not given to beginFrame() if the last frame failed, a destructor cannot throw it
+    if(m_error)
+    {
+        try
+        {
+            std::rethrow_exception(m_error);
+        }
+        catch(const std::exception& e)
+        {
+            std::cerr << "The render thread failed to draw the last frame: " << e.what() << std::endl;
+        }
+        catch(...)
+        {
+            std::cerr << "The render thread failed to draw the last frame" << std::endl;
+        }
+    }
+
+    m_window.setActive(true);
+
+    // The render thread bound its own objects, and the viewport may have changed since
+    GL::invalidateState();
+}
+
+RenderThread::Frame& RenderThread::beginFrame()
+{
+    std::unique_lock lock(m_mutex);
+
+    // Both snapshots are in use: one is drawn, the other one is waiting to be drawn
+    m_condition.wait(lock, [this]() { return !m_ready[m_writeIndex] || m_error; });
+
+    if(m_error)
+    {
+        std::rethrow_exception(std::exchange(m_error, nullptr));
+    }
+
+    Frame& frame = m_frames[m_writeIndex];
+    frame.queue.clear();
+    frame.onRender = nullptr;
+    frame.start = Time::now();
+
+    return frame;
+}
+
+void RenderThread::endFrame()
+{
+    {
+        std::lock_guard lock(m_mutex);
+
+        m_ready[m_writeIndex] = true;
+        m_writeIndex = (m_writeIndex + 1) % frameCount;
+    }
+
+    m_condition.notify_all();
+
+    m_window.onUpdate();
+}
+
+const FrameTimer& RenderThread::getTimer() const
+{
+    return m_timer;
+}
+
+Renderer::Stats RenderThread::getStats() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_stats;
+}
+
+GL::Counters RenderThread::getCounters() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_counters;
+}
+
+TextureRegistry::Stats RenderThread::getTextureStats() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_textureStats;
+}
+
+void RenderThread::run()
+{
+    m_window.setActive(true);
+
+    // The cache was filled by the main thread, the real state is the one of the context
+    GL::invalidateState();
+
+    while(true)
+    {
+        Frame *frame;
+
+        {
+            std::unique_lock lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_stop || m_ready[m_readIndex]; });
+
+            // The last snapshot is not drawn if the thread is stopped
+            if(m_stop)
+            {
+                break;
+            }
+
+            frame = &m_frames[m_readIndex];
+        }
+
+        try
+        {
+            render(*frame);
+        }
+        catch(...)
+        {
+            // Given to the main thread, at the next beginFrame()
+            std::lock_guard lock(m_mutex);
+            m_error = std::current_exception();
+            m_stop = true;
+        }
+
+        {
+            std::lock_guard lock(m_mutex);
+
+            m_stats = m_renderer.getStats();
+            m_counters = GL::getCounters();
+            m_textureStats = TextureRegistry::getGlobal().getStats();
+            m_ready[m_readIndex] = false;
+            m_readIndex = (m_readIndex + 1) % frameCount;
+        }
+
+        m_renderer.resetStats();
+        GL::resetCounters();
+        m_condition.notify_all();
+    }
+
+    m_window.setActive(false);
+}
+
+void RenderThread::render(Frame& frame)
+{
+    m_renderer.setSorting(frame.sorting);
+    m_renderer.setVertexFormat(frame.vertexFormat);
+
+    GL::viewport(0, 0, frame.viewport.x, frame.viewport.y);
+    glClearColor(frame.clearColor.r, frame.clearColor.g, frame.clearColor.b, frame.clearColor.a);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    m_renderer.submit(frame.queue);
+
+    if(frame.onRender)
+    {
+        frame.onRender();
+    }
+
+    m_window.swapBuffers();
+    m_timer.presented(frame.start);
+
+    // Between two frames, the textures are only used on this thread
+    TextureRegistry::getGlobal().trim();
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Window.hpp"
+#include <wrappers/gl/Renderer.hpp>
+#include <wrappers/gl/RenderQueue.hpp>
+#include <wrappers/gl/TextureRegistry.hpp>
+#include <utility/time/Time.hpp>
+#include <glm/glm.hpp>
+#include <array>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/// @brief Latency and throughput of the frames, smoothed over the last frames.
+/// @details The latency is the time from the beginning of the preparation of a frame (when the input is read) to
+/// its presentation. The frame time is the time between two presentations, its inverse is the throughput.
+/// @remarks Thread-safe, the frames can be presented on another thread than the one reading the timings.
+class FrameTimer
+{
+public:
+    /// @brief A frame was presented.
+    /// @param start When the preparation of the frame began.
+    void presented(Time start);
+
+    Time getLatency() const;
+    Time getFrameTime() const;
+
+    /// @brief Forget the previous frames, for example when the way the frames are rendered changes.
+    void reset();
+
+private:
+    /// @brief Weight of the last frame in the averages.
+    static constexpr float smoothing = 0.05f;
+
+    mutable std::mutex m_mutex;
+    Time m_latency;
+    Time m_frameTime;
+    Time m_lastPresentation;
+    bool m_first{true};
+};
+
+/// @brief Renders the frames on a dedicated thread owning the OpenGL context, while the next frame is prepared.
+/// @details
+/// The main thread prepares each frame in a snapshot, without calling OpenGL: the batched geometry is captured by a
+/// Renderer (see Renderer::setCapture()) in the queue of the frame, already transformed and colored, and what is
+/// not batched can be given as a callback. Then the frame is handed to the render thread, which draws it with its
+/// own Renderer and swaps the buffers, while the main thread prepares the next frame in the other snapshot.
+/// So the simulation of the frame N + 1 overlaps the rendering and the presentation of the frame N, at the cost of
+/// one frame of latency. If the main thread is faster, it waits in beginFrame() until a snapshot is free.
+/// The OpenGL context is released by the main thread in the constructor, and given back in the destructor.
+/// While the render thread runs, the main thread should not call OpenGL at all, including the objects that upload
+/// lazily (like the glyphs of a Font), the drawables that are not batched and Window::display().
+class RenderThread
+{
+public:
+    /// @brief The snapshot of a frame, everything the render thread needs to draw it.
+    struct Frame
+    {
+        RenderQueue queue; ///< The batched geometry.
+        bool sorting{false}; ///< If the geometry is sorted by state, see Renderer::setSorting().
+        Vertex::Format vertexFormat{Vertex::Format::Full};
+        glm::vec4 clearColor{0.0f, 0.0f, 0.0f, 1.0f};
+        glm::ivec2 viewport{0}; ///< The size of the window when the frame was prepared.
+
+        /// @brief Called on the render thread after the geometry is drawn, for example to render ImGui.
+        /// @details It should only use data owned by the callback, the main thread is already preparing the next frame.
+        std::function<void()> onRender;
+
+        Time start; ///< When the preparation began, to measure the latency.
+    };
+
+    explicit RenderThread(Window& window);
+
+    /// @brief Stop the render thread, the snapshot waiting to be drawn is dropped.
+    /// @details An exception thrown while drawing the last frame, not given to beginFrame() yet, is written to
+    /// std::cerr.
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    /// @brief Get the snapshot to prepare the next frame, waiting if both snapshots are in use.
+    /// @details The snapshot is cleared.
+    /// @throws The exception thrown by the render thread while drawing a frame, if any. The render thread is stopped.
+    Frame& beginFrame();
+
+    /// @brief Hand the snapshot given by beginFrame() to the render thread.
+    /// @details Emits Window::onUpdate on the calling thread, like Window::display().
+    void endFrame();
+
+    const FrameTimer& getTimer() const;
+
+    /// @brief Get the counters of the renderer of the last drawn frame.
+    Renderer::Stats getStats() const;
+
+    /// @brief Get the OpenGL counters of the last drawn frame.
+    /// @details The GL state cache and its counters are only used by the render thread, this is a copy.
+    GL::Counters getCounters() const;
+
+    /// @brief Get the counters of the TextureRegistry, after the eviction of the last drawn frame.
+    /// @details The registry is only used by the render thread, this is a copy.
+    TextureRegistry::Stats getTextureStats() const;
+
+private:
+    /// @brief The snapshots are used in turn.
+    static constexpr std::size_t frameCount = 2;
+
+    void run();
+
+    /// @brief Draw a frame, on the render thread.
+    void render(Frame& frame);
+
+    Window& m_window;
+
+    std::array<Frame, frameCount> m_frames;
+    std::array<bool, frameCount> m_ready{}; ///< The snapshot is waiting for the render thread, or being drawn.
+    std::size_t m_writeIndex{0}; ///< The snapshot prepared by the main thread.
+    std::size_t m_readIndex{0}; ///< The next snapshot drawn by the render thread.
+    bool m_stop{false};
+    std::exception_ptr m_error; ///< Thrown by the render thread.
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+
+    Renderer m_renderer; ///< Only used by the render thread.
+    Renderer::Stats m_stats; ///< Copied from the renderer after each frame.
+    GL::Counters m_counters; ///< Copied from the GL state cache after each frame.
+    TextureRegistry::Stats m_textureStats; ///< Copied from the texture registry after each frame.
+    FrameTimer m_timer;
+
+    std::thread m_thread; ///< Started last, once all the other members are initialized.
+};
@@ -42,8 +42,8 @@ void Window::createContext()
     }
 
     // We will need blending
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GL::setBlending(true);
+    GL::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     printGPUInfo();
 }
@@ -86,6 +86,15 @@ void Window::handleEvents()
             case SDL_QUIT:
                 m_running = false;
                 break;
+
+            case SDL_WINDOWEVENT:
+                // Otherwise the context is on a RenderThread, which sets the viewport at each frame
+                if(e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED && isActive())
+                {
+                    const glm::vec2 size = getSize();
+                    GL::viewport(0, 0, static_cast<GLsizei>(size.x), static_cast<GLsizei>(size.y));
+                }
+                break;
         }
 
         onEvent(e);
@@ -96,9 +105,27 @@ void Window::display()
 {
     onUpdate();
 
+    swapBuffers();
+}
+
+void Window::swapBuffers()
+{
     SDL_GL_SwapWindow(m_window);
 }
 
+void Window::setActive(bool active)
+{
+    if(SDL_GL_MakeCurrent(m_window, active ? m_context : nullptr) != 0)
+    {
+        throw SDL::Exception("Failed to change the current OpenGL context");
+    }
+}
+
+bool Window::isActive() const
+{
+    return SDL_GL_GetCurrentContext() == m_context;
+}
+
 glm::vec2 Window::getSize() const
 {
     int w, h;
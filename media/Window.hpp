@@ -23,8 +23,21 @@ public:
     void handleEvents();
 
     /// @brief Render the window by swapping OpenGL buffers.
+    /// @details Same as emitting onUpdate, then swapBuffers().
     void display();
 
+    /// @brief Swap the OpenGL buffers, from the thread where the context is active.
+    /// @details Blocks until the frame is presented if vertical synchronization is enabled.
+    void swapBuffers();
+
+    /// @brief Make the OpenGL context current on the calling thread, or release it.
+    /// @details The context is active on the thread that created the window. It can only be active on one thread at
+    /// a time, so it should be released before being activated on another thread, like by a RenderThread.
+    void setActive(bool active);
+
+    /// @returns If the OpenGL context is current on the calling thread.
+    bool isActive() const;
+
     /// @brief Get the size of the window in pixel.
     glm::vec2 getSize() const;
 
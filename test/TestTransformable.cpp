@@ -1,12 +1,78 @@
 #include "TestTransformable.hpp"
 #include <wrappers/gl/VertexArray.hpp>
 #include <wrappers/gl/ConvexShape.hpp>
-#include <wrappers/gl/Line.hpp>
+#include <wrappers/gl/Outline.hpp>
+#include <wrappers/gl/Bounds.hpp>
+#include <wrappers/gl/DebugDraw.hpp>
+#include <wrappers/gl/StreamBuffer.hpp>
+#include <wrappers/gl/TextureRegistry.hpp>
 #include <utility/math.hpp>
 #include <imgui.h>
 #include <imgui_impl_opengl3.h>
 #include <imgui_impl_sdl.h>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/matrix_transform_2d.hpp>
+#include <random>
+#include <memory>
+
+namespace
+{
+    /// @brief Copy of the draw data of ImGui, rendered by the render thread while the next frame is prepared.
+    struct ImGuiSnapshot
+    {
+        ImGuiSnapshot(const ImDrawData& source, std::vector<std::shared_ptr<Texture>> textures)
+            : data(source), textures(std::move(textures))
+        {
+            for(int i = 0; i < source.CmdListsCount; ++i)
+            {
+                lists.push_back(source.CmdLists[i]->CloneOutput());
+            }
+
+            data.CmdLists = lists.data();
+        }
+
+        ~ImGuiSnapshot()
+        {
+            for(ImDrawList *list : lists)
+            {
+                IM_DELETE(list);
+            }
+        }
+
+        ImGuiSnapshot(const ImGuiSnapshot&) = delete;
+        ImGuiSnapshot& operator=(const ImGuiSnapshot&) = delete;
+
+        ImDrawData data;
+        std::vector<ImDrawList*> lists;
+        std::vector<std::shared_ptr<Texture>> textures; ///< Kept alive until they are drawn
+    };
+
+    /// @brief Replace the textures given to ImGui::Image() by their OpenGL names, on the thread owning the context.
+    /// @details Binding a texture restores it if it was evicted, and marks it as used for the TextureRegistry.
+    void resolveTextures(ImDrawData& data, const std::vector<std::shared_ptr<Texture>>& textures)
+    {
+        if(textures.empty())
+        {
+            return;
+        }
+
+        for(int i = 0; i < data.CmdListsCount; ++i)
+        {
+            for(ImDrawCmd& command : data.CmdLists[i]->CmdBuffer)
+            {
+                for(const std::shared_ptr<Texture>& texture : textures)
+                {
+                    if(command.TextureId == static_cast<ImTextureID>(texture.get()))
+                    {
+                        texture->bind();
+                        command.TextureId = reinterpret_cast<ImTextureID>(static_cast<std::intptr_t>(texture->getID()));
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
 
 TestTransformable::TestTransformable()
     : m_window("Test transformable", 800, 800)
@@ -15,6 +81,10 @@ TestTransformable::TestTransformable()
 
     m_shader.load(path / "vert.glsl", path / "frag.glsl");
     m_font.load(path / "fonts/monofonto.ttf", 64);
+    m_imagePath = path / "screenshots/img.png";
+
+    // The evicted textures are restored without stalling the frame, see run() for the render thread
+    TextureRegistry::getGlobal().setLoader(&m_textureLoader);
 
     m_current = &m_triangle;
 
@@ -27,6 +97,55 @@ TestTransformable::TestTransformable()
     m_triangleVertices[0] = {{1, 0}, {1, 0, 0, 1}};
     m_triangleVertices[1] = {{0, 1}, {0, 1, 0, 1}};
     m_triangleVertices[2] = {{-1, 0}, {0, 0, 1, 1}};
+
+    setCircleGrid(m_circleSide);
+
+    m_pickIndex.insert(m_triangle);
+    m_pickIndex.insert(m_circle);
+}
+
+void TestTransformable::setCrowd(int count)
+{
+    m_crowd.clear();
+    m_crowdDrawables.clear();
+
+    // Small sprites in a disk of radius 10, mostly outside the default view
+    std::mt19937 random(0);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    for(int i = 0; i < count; ++i)
+    {
+        Sprite& sprite = m_crowd.emplace_back();
+
+        const float angle = unit(random) * TAU;
+        const float radius = std::sqrt(unit(random)) * 10.0f;
+
+        sprite.setPosition(glm::vec2{std::cos(angle), std::sin(angle)} * radius);
+        sprite.setRotation(angle);
+        sprite.setScale(glm::vec2{0.05f});
+        sprite.setColor({unit(random), unit(random), 1.0f, 1.0f});
+
+        m_crowdDrawables.push_back(&sprite);
+    }
+}
+
+void TestTransformable::setCircleGrid(int side)
+{
+    // Grid of small circles, all drawn in one instanced draw call
+    m_circles.clear();
+
+    for(int y = 0; y < side; ++y)
+    {
+        for(int x = 0; x < side; ++x)
+        {
+            ShapeInstancesBase::Instance instance;
+            instance.setPosition({(x + 0.5f) / side * 4.0f - 2.0f, (y + 0.5f) / side * 4.0f - 2.0f});
+            instance.setScale(glm::vec2{1.5f / side});
+            instance.color = {static_cast<float>(x) / side, static_cast<float>(y) / side, 1.0f, 1.0f};
+
+            m_circles.add(instance);
+        }
+    }
 }
 
 void TestTransformable::draw()
@@ -37,6 +156,27 @@ void TestTransformable::draw()
     RenderStates states;
     states.view = view;
     states.shader = &m_shader;
+    // With the render thread, the geometry is always captured by the renderer
+    states.renderer = m_batching || m_renderThread ? &m_renderer : nullptr;
+    states.culling = m_culling;
+
+    // The render thread owns the GL state cache, so the viewport should not be read from it
+    states.viewport = glm::ivec2(m_window.getSize());
+
+    // Needs the OpenGL context
+    if(!m_renderThread)
+    {
+        TextureRegistry::getGlobal().trim();
+
+        try
+        {
+            m_textureLoader.update();
+        }
+        catch(const std::exception& e)
+        {
+            m_textureError = e.what();
+        }
+    }
 
     if(auto *tr = dynamic_cast<Transformable*>(m_current))
     {
@@ -46,14 +186,22 @@ void TestTransformable::draw()
         tr->setScale(m_scale);
     }
 
+    const auto vertexFormat = static_cast<Vertex::Format>(m_vertexFormat);
+    m_renderer.setVertexFormat(vertexFormat);
+
     if(auto *shape = dynamic_cast<Shape*>(m_current))
     {
+        shape->setVertexFormat(vertexFormat);
+        shape->setIndexed(m_indexed);
         shape->setOutlineColor(m_outlineColor);
         shape->setOutlineThickness(m_noOutline ? 0.0f : m_outlineThickness);
         shape->setColor(m_fillColor);
     }
 
-    if(auto *txt = dynamic_cast<Text*>(m_current))
+    // The glyphs are uploaded when they are used for the first time, which needs the OpenGL context
+    auto *txt = dynamic_cast<Text*>(m_current);
+
+    if(txt && !m_renderThread)
     {
         txt->setColor(m_fillColor);
 
@@ -61,6 +209,31 @@ void TestTransformable::draw()
         txt->setString(m_string);
     }
 
+    const Circle::Mode circleMode = m_sdf ? Circle::Mode::SDF : Circle::Mode::Tessellated;
+    m_circle.setMode(circleMode);
+
+    if(m_current == &m_circles)
+    {
+        // Do not upload all the instances again if nothing changed
+        const float outlineThickness = m_noOutline ? 0.0f : m_outlineThickness;
+        const ShapeInstancesBase::Instance& first = std::as_const(m_circles).getInstance(0);
+
+        if(first.outlineColor != m_outlineColor || first.outlineThickness != outlineThickness)
+        {
+            for(std::size_t i = 0; i < m_circles.getInstanceCount(); ++i)
+            {
+                ShapeInstancesBase::Instance& instance = m_circles.getInstance(i);
+                instance.outlineColor = m_outlineColor;
+                instance.outlineThickness = outlineThickness;
+            }
+        }
+
+        if(std::as_const(m_circles).getShape().getMode() != circleMode)
+        {
+            m_circles.getShape().setMode(circleMode);
+        }
+    }
+
     if(m_current == &m_triangle)
     {
         m_triangle.setVerticesCount(3);
@@ -70,16 +243,77 @@ void TestTransformable::draw()
         }
     }
 
-    drawGrid(states);
-    m_current->draw(states);
+    // Compute all the matrices at once, before drawing
+    TransformStore::getGlobal().update(&m_threadPool);
+
+    // Only the batched drawables can be captured for the render thread
+    const bool batched = dynamic_cast<Shape*>(m_current) && !(m_current == &m_circle && m_sdf);
+
+    if(!m_renderThread)
+    {
+        m_grid.draw(states);
+    }
+
+    if(!m_renderThread || batched)
+    {
+        m_current->draw(states);
+    }
+
+    const Time crowdStart = Time::now();
+
+    if(m_parallelRecording && states.renderer)
+    {
+        m_renderer.record(m_threadPool, m_crowdDrawables, states);
+    }
+    else
+    {
+        for(const Drawable *drawable : m_crowdDrawables)
+        {
+            drawable->draw(states);
+        }
+    }
+
+    m_crowdTime = Time::now() - crowdStart;
+
+    DebugDraw& debugDraw = DebugDraw::getGlobal();
+
+    if(m_current == &m_text && !m_renderThread)
+    {
+        // Same origin as the Font
+        debugDraw.fillRect({0.0f, 0.0f}, m_text.getSize() / m_text.getFont()->getLineHeight(), {0, 1, 0, 0.5});
+    }
+
+    if(auto *transformable = dynamic_cast<Transformable*>(m_current))
+    {
+        const glm::vec2& position = transformable->getPosition();
+        debugDraw.circle(position, 0.1f, {1, 1, 0, 1});
+        debugDraw.text(position + glm::vec2{0.15f, 0.0f}, "position", m_font, {1, 1, 0, 1}, 0.25f / m_font.getLineHeight());
+    }
+
+    // Only the shapes moved since the last frame are updated
+    m_pickIndex.refresh();
+
+    const glm::vec2 mouse = SpatialGrid::fromClipSpace(states.view, m_window.getInput().getMouseInClipSpace());
+    std::vector<SpatialGrid::Id> hovered;
+    m_pickIndex.getGrid().query(mouse, hovered);
 
-    if(m_current == &m_text)
+    for(SpatialGrid::Id id : hovered)
     {
-        Sprite sprite;
-        sprite.setScale({m_text.getSize() / m_text.getFont()->getLineHeight()});
-        sprite.setOrigin({-0.5f,  -0.5f}); // Same origin as the Font
-        sprite.setColor({0, 1, 0, 0.5});
-        sprite.draw(states);
+        const Rect& bounds = m_pickIndex.getGrid().getBounds(id);
+        debugDraw.rect(bounds.bottomLeft(), bounds.topRight(), {1, 0, 1, 1});
+    }
+
+    if(m_renderThread)
+    {
+        // Drawn directly with OpenGL
+        debugDraw.clear();
+    }
+    else
+    {
+        debugDraw.flush(states);
+
+        // Everything drawn by the renderer should be rendered before ImGui
+        m_renderer.flush();
     }
 
     ImGui::SliderFloat("Zoom", &m_zoom, 0.1f, 6.0f);
@@ -97,6 +331,10 @@ void TestTransformable::draw()
         {
             m_current = &m_circle;
         }
+        if(ImGui::Selectable("Instanced circles", m_current == &m_circles))
+        {
+            m_current = &m_circles;
+        }
         if(ImGui::Selectable("Text", m_current == &m_text))
         {
             m_current = &m_text;
@@ -134,12 +372,443 @@ void TestTransformable::draw()
             ImGui::SliderFloat2(label.str().c_str(), &m_triangleVertices[i].pos.x, -2.0f, 2.0f);
         }
     }
+    if(ImGui::CollapsingHeader("Grid"))
+    {
+        float spacing = m_grid.getSpacing();
+        float subdivision = m_grid.getSubdivision();
+        float thickness = m_grid.getThickness();
+
+        if(ImGui::SliderFloat("Spacing", &spacing, 0.1f, 5.0f))
+        {
+            m_grid.setSpacing(spacing);
+        }
+        if(ImGui::SliderFloat("Subdivision", &subdivision, 2.0f, 10.0f))
+        {
+            m_grid.setSubdivision(subdivision);
+        }
+        if(ImGui::SliderFloat("Line thickness", &thickness, 1.0f, 5.0f))
+        {
+            m_grid.setThickness(thickness);
+        }
+    }
+    if(ImGui::CollapsingHeader("Circle"))
+    {
+        ImGui::Checkbox("SDF rendering", &m_sdf);
+
+        if(ImGui::SliderInt("Instanced grid side", &m_circleSide, 1, 1000))
+        {
+            setCircleGrid(m_circleSide);
+        }
+
+        ImGui::Text("%zu instanced circles", m_circles.getInstanceCount());
+    }
+    if(ImGui::CollapsingHeader("Crowd"))
+    {
+        ImGui::SliderInt("Sprites", &m_crowdSize, 0, 200000);
+
+        if(ImGui::Button("Apply"))
+        {
+            setCrowd(m_crowdSize);
+        }
+
+        ImGui::Checkbox("Parallel recording (with batching)", &m_parallelRecording);
+        ImGui::Text("Submitted in %.3f ms", m_crowdTime.asSeconds() * 1000.0f);
+    }
+    if(ImGui::CollapsingHeader("Textures"))
+    {
+        ImGui::SliderInt("Count", &m_textureCount, 1, 1000);
+
+        if(m_renderThread)
+        {
+            ImGui::TextDisabled("Textures cannot be loaded while the render thread owns the context");
+        }
+        else
+        {
+            const bool synchronous = ImGui::Button("Load synchronously");
+            ImGui::SameLine();
+            const bool asynchronous = ImGui::Button("Load asynchronously");
+
+            if(synchronous || asynchronous)
+            {
+                const Time start = Time::now();
+
+                m_textures.clear();
+                m_textureError.clear();
+
+                for(int i = 0; i < m_textureCount; ++i)
+                {
+                    try
+                    {
+                        if(asynchronous)
+                        {
+                            m_textures.push_back(m_textureLoader.load(m_imagePath));
+                        }
+                        else
+                        {
+                            m_textures.emplace_back(std::make_shared<Texture>())->load(m_imagePath);
+                        }
+                    }
+                    catch(const std::exception& e)
+                    {
+                        m_textureError = e.what();
+                        break;
+                    }
+                }
+
+                m_textureLoadTime = Time::now() - start;
+            }
+        }
+
+        int budget = static_cast<int>(m_textureLoader.getBudget() >> 10);
+        if(ImGui::SliderInt("Upload budget (KiB/frame)", &budget, 64, 65536))
+        {
+            m_textureLoader.setBudget(static_cast<std::size_t>(budget) << 10);
+        }
+
+        ImGui::Text("Blocked the frame for %.3f ms", m_textureLoadTime.asSeconds() * 1000.0f);
+        ImGui::Text("%zu textures still loading", m_textureLoader.getPendingCount());
+
+        // Used by the render thread when there is one
+        if(!m_renderThread)
+        {
+            TextureRegistry& registry = TextureRegistry::getGlobal();
+
+            int memoryBudget = static_cast<int>(registry.getBudget() >> 20);
+            if(ImGui::SliderInt("GPU memory budget (MiB)", &memoryBudget, 1, 4096))
+            {
+                registry.setBudget(static_cast<std::size_t>(memoryBudget) << 20);
+            }
+        }
+
+        const TextureRegistry::Stats textureStats = m_renderThread ? m_renderThread->getTextureStats()
+                                                                   : TextureRegistry::getGlobal().getStats();
+
+        ImGui::Text("%zu textures, %.1f MiB resident, %zu evictions", textureStats.textureCount,
+                    static_cast<double>(textureStats.memorySize) / (1 << 20), textureStats.evictionCount);
+
+        if(!m_textureError.empty())
+        {
+            ImGui::TextColored({1.0f, 0.3f, 0.3f, 1.0f}, "%s", m_textureError.c_str());
+        }
+
+        // The rows of the textures are from the bottom to the top
+        for(std::size_t i = 0; i < std::min<std::size_t>(m_textures.size(), 64); ++i)
+        {
+            if(i % 8 != 0)
+            {
+                ImGui::SameLine();
+            }
+
+            // The OpenGL name can change when the texture is evicted, it is resolved when ImGui is rendered
+            m_imguiTextures.push_back(m_textures[i]);
+            ImGui::Image(static_cast<ImTextureID>(m_textures[i].get()), {32.0f, 32.0f}, {0.0f, 1.0f}, {1.0f, 0.0f});
+        }
+    }
     if(ImGui::CollapsingHeader("Text"))
     {
         ImGui::Text("Text size : %fx%fpx", m_text.getSize().x, m_text.getSize().y);
 
         ImGui::InputText("String", m_string, sizeof(m_string));
     }
+
+    if(ImGui::CollapsingHeader("Statistics"))
+    {
+        Renderer::Stats stats = m_renderer.getStats();
+
+        if(m_renderThread)
+        {
+            // The geometry is drawn by the renderer of the render thread, only captured by this one
+            const Renderer::Stats drawn = m_renderThread->getStats();
+            stats.drawCalls = drawn.drawCalls;
+            stats.vertices = drawn.vertices;
+            stats.indices = drawn.indices;
+            stats.stateChanges = drawn.stateChanges;
+        }
+
+        ImGui::Checkbox("Batching", &m_batching);
+        ImGui::Text("Draw calls: %d (%d without batching)", stats.drawCalls, stats.submitted);
+        ImGui::Text("Batched vertices: %d, indices: %d", stats.vertices, stats.indices);
+        ImGui::Checkbox("Indexed shapes (without batching)", &m_indexed);
+        ImGui::Checkbox("Culling", &m_culling);
+
+        bool sorting = m_renderer.isSorting();
+
+        if(ImGui::Checkbox("Sort by state (render queue)", &sorting))
+        {
+            m_renderer.setSorting(sorting);
+        }
+
+        ImGui::Text("State changes: %d", stats.stateChanges);
+        ImGui::Text("Drawables: %d drawn, %d culled", stats.drawn, stats.culled);
+
+        // A copy, the render thread owns the GL state cache
+        const GL::Counters counters = m_renderThread ? m_renderThread->getCounters() : GL::getCounters();
+        ImGui::Text("GL state calls: %d issued, %d skipped", counters.issued, counters.skipped);
+
+        ImGui::RadioButton("Full vertices", &m_vertexFormat, static_cast<int>(Vertex::Format::Full));
+        ImGui::SameLine();
+        ImGui::RadioButton("Packed", &m_vertexFormat, static_cast<int>(Vertex::Format::Packed));
+        ImGui::SameLine();
+        ImGui::RadioButton("Compact", &m_vertexFormat, static_cast<int>(Vertex::Format::Compact));
+
+        // Vertices are the same count whatever the format, only their size changes
+        const std::size_t vertexSize = Vertex::getSize(static_cast<Vertex::Format>(m_vertexFormat));
+        ImGui::Text("Stream buffer: %s", StreamBuffer::getGlobal().isPersistent() ? "persistent mapping" : "orphaning");
+        ImGui::Text("Uploaded: %zu bytes/frame (%zu bytes per vertex, %d%% less than Full)",
+                    counters.uploadedBytes, vertexSize, static_cast<int>(100 - vertexSize * 100 / sizeof(Vertex)));
+    }
+
+    if(ImGui::CollapsingHeader("Transform benchmark"))
+    {
+        benchmarkTransforms();
+    }
+
+    if(ImGui::CollapsingHeader("Outline benchmark"))
+    {
+        benchmarkOutline();
+    }
+
+    if(ImGui::CollapsingHeader("Spatial index benchmark"))
+    {
+        benchmarkSpatialIndex();
+    }
+
+    if(ImGui::CollapsingHeader("Render thread"))
+    {
+        ImGui::Checkbox("Render on a dedicated thread", &m_useRenderThread);
+        ImGui::TextDisabled("Only the batched shapes and the crowd are drawn in this mode");
+
+        const FrameTimer& timer = m_renderThread ? m_renderThread->getTimer() : m_frameTimer;
+        const float frameTime = timer.getFrameTime().asSeconds();
+
+        ImGui::Text("Latency: %.2f ms", timer.getLatency().asSeconds() * 1000.0f);
+        ImGui::Text("Frame time: %.2f ms (%.0f frames/s)", frameTime * 1000.0f, frameTime > 0.0f ? 1.0f / frameTime : 0.0f);
+    }
+
+    m_renderer.resetStats();
+
+    // Modified by the render thread
+    if(!m_renderThread)
+    {
+        GL::resetCounters();
+    }
+}
+
+void TestTransformable::benchmarkTransforms()
+{
+    ImGui::SliderInt("Transforms", &m_benchmarkCount, 1000, 1000000);
+
+    while(m_benchmarkStore.getCapacity() < static_cast<std::size_t>(m_benchmarkCount))
+    {
+        const auto index = m_benchmarkStore.allocate();
+        m_benchmarkStore.setPosition(index, {index % 100, index / 100});
+        m_benchmarkStore.setScale(index, {2.0f, 0.5f});
+        m_benchmarkStore.setOrigin(index, {0.5f, 0.5f});
+    }
+
+    const std::size_t count = m_benchmarkStore.getCapacity();
+    const float now = Time::now().asSeconds();
+
+    // Move all the transforms, so they are all dirty
+    auto rotateAll = [&]() {
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            m_benchmarkStore.setRotation(static_cast<TransformStore::Index>(i), now + static_cast<float>(i) * 0.001f);
+        }
+    };
+
+    // Reference: the chained glm calls
+    m_benchmarkMatrices.resize(count);
+    Time start = Time::now();
+
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        const auto index = static_cast<TransformStore::Index>(i);
+
+        glm::mat3 matrix(1.0f);
+        matrix = glm::translate(matrix, m_benchmarkStore.getPosition(index));
+        matrix = glm::rotate(matrix, now + static_cast<float>(i) * 0.001f);
+        matrix = glm::scale(matrix, m_benchmarkStore.getScale(index));
+        matrix = glm::translate(matrix, -m_benchmarkStore.getOrigin(index));
+
+        m_benchmarkMatrices[i] = matrix;
+    }
+
+    const Time glmTime = Time::now() - start;
+
+    rotateAll();
+    start = Time::now();
+    m_benchmarkStore.update();
+    const Time singleTime = Time::now() - start;
+
+    rotateAll();
+    start = Time::now();
+    m_benchmarkStore.update(&m_threadPool);
+    const Time parallelTime = Time::now() - start;
+
+    ImGui::Text("glm matrix products: %.3f ms", glmTime.asSeconds() * 1000.0f);
+    ImGui::Text("TransformStore, 1 thread: %.3f ms", singleTime.asSeconds() * 1000.0f);
+    ImGui::Text("TransformStore, %u threads: %.3f ms", m_threadPool.getConcurrency(), parallelTime.asSeconds() * 1000.0f);
+}
+
+void TestTransformable::benchmarkOutline()
+{
+    ImGui::SliderInt("Polygon vertices", &m_benchmarkPolygonSize, 1000, 1000000);
+
+    const auto size = static_cast<std::size_t>(m_benchmarkPolygonSize);
+
+    if(m_benchmarkPolygon.size() != size)
+    {
+        // Star-shaped, so that half of the vertices are concave
+        m_benchmarkPolygon.resize(size);
+
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            const float angle = static_cast<float>(i) / static_cast<float>(size) * TAU;
+            const float radius = i % 2 == 0 ? 1.0f : 0.9f;
+
+            m_benchmarkPolygon[i] = Vertex{glm::vec2{std::cos(angle), std::sin(angle)} * radius};
+        }
+    }
+
+    m_benchmarkOutline.resize(size);
+
+    Time start = Time::now();
+    Outline::computeReference(m_benchmarkPolygon, 0.1f, m_benchmarkOutline);
+    const Time referenceTime = Time::now() - start;
+
+    start = Time::now();
+    Outline::compute(m_benchmarkPolygon, 0.1f, m_benchmarkOutline);
+    const Time singleTime = Time::now() - start;
+
+    start = Time::now();
+    Outline::compute(m_benchmarkPolygon, 0.1f, m_benchmarkOutline, &m_threadPool);
+    const Time parallelTime = Time::now() - start;
+
+    ImGui::Text("acos/tan, 1 thread: %.3f ms", referenceTime.asSeconds() * 1000.0f);
+    ImGui::Text("Miter kernel, 1 thread: %.3f ms", singleTime.asSeconds() * 1000.0f);
+    ImGui::Text("Miter kernel, %u threads: %.3f ms", m_threadPool.getConcurrency(), parallelTime.asSeconds() * 1000.0f);
+}
+
+void TestTransformable::benchmarkSpatialIndex()
+{
+    ImGui::RadioButton("10k", &m_benchmarkRectCount, 10000);
+    ImGui::SameLine();
+    ImGui::RadioButton("100k", &m_benchmarkRectCount, 100000);
+    ImGui::SameLine();
+    ImGui::RadioButton("1M", &m_benchmarkRectCount, 1000000);
+
+    const auto count = static_cast<std::size_t>(m_benchmarkRectCount);
+
+    // Random rects of about half a cell, with a constant density
+    const float side = std::sqrt(static_cast<float>(count)) * 2.0f;
+    std::mt19937 random(static_cast<std::mt19937::result_type>(count));
+    std::uniform_real_distribution<float> position(-side / 2.0f, side / 2.0f);
+    std::uniform_real_distribution<float> size(0.1f, 1.5f);
+
+    if(m_benchmarkRects.size() != count)
+    {
+        m_benchmarkRects.resize(count);
+
+        for(Rect& rect : m_benchmarkRects)
+        {
+            rect = Rect{{size(random), size(random)}, {position(random), position(random)}};
+        }
+
+        const Time start = Time::now();
+        m_benchmarkGrid.clear();
+
+        for(const Rect& rect : m_benchmarkRects)
+        {
+            m_benchmarkGrid.insert(rect);
+        }
+
+        m_benchmarkGridTime = Time::now() - start;
+    }
+
+    // Areas like the view of the demo, 20 units wide
+    constexpr int queryCount = 100;
+    std::vector<Rect> areas(queryCount);
+
+    for(Rect& area : areas)
+    {
+        area = Rect{{20.0f, 20.0f}, {position(random), position(random)}};
+    }
+
+    std::vector<SpatialGrid::Id> result;
+    std::size_t found = 0;
+
+    Time start = Time::now();
+
+    for(const Rect& area : areas)
+    {
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            found += Bounds::intersects(m_benchmarkRects[i], area);
+        }
+    }
+
+    const Time linearTime = Time::now() - start;
+    start = Time::now();
+
+    for(const Rect& area : areas)
+    {
+        result.clear();
+        m_benchmarkGrid.query(area, result);
+    }
+
+    const Time gridTime = Time::now() - start;
+    start = Time::now();
+
+    for(const Rect& area : areas)
+    {
+        result.clear();
+        m_benchmarkGrid.query(area.center, result);
+    }
+
+    const Time pointTime = Time::now() - start;
+
+    ImGui::Text("Build: %.3f ms, %zu cells", m_benchmarkGridTime.asSeconds() * 1000.0f, m_benchmarkGrid.getCellCount());
+    ImGui::Text("Area query, linear: %.4f ms (%zu rects)",
+                linearTime.asSeconds() * 1000.0f / queryCount, found / queryCount);
+    ImGui::Text("Area query, grid: %.4f ms", gridTime.asSeconds() * 1000.0f / queryCount);
+    ImGui::Text("Point query, grid: %.4f ms", pointTime.asSeconds() * 1000.0f / queryCount);
+}
+
+void TestTransformable::runThreadedFrame()
+{
+    // Waits for the render thread if it is one frame late
+    RenderThread::Frame& frame = m_renderThread->beginFrame();
+
+    m_window.handleEvents();
+
+    // The device objects of the OpenGL backend already exist, so this does not call OpenGL
+    ImGui_ImplOpenGL3_NewFrame();
+    ImGui_ImplSDL2_NewFrame();
+    ImGui::NewFrame();
+
+    m_renderer.setCapture(&frame.queue);
+    draw();
+    m_renderer.setCapture(nullptr);
+
+    ImGui::Render();
+
+    frame.sorting = m_renderer.isSorting();
+    frame.vertexFormat = m_renderer.getVertexFormat();
+    frame.viewport = glm::ivec2(m_window.getSize());
+
+    auto snapshot = std::make_shared<ImGuiSnapshot>(*ImGui::GetDrawData(), std::move(m_imguiTextures));
+    m_imguiTextures.clear();
+
+    frame.onRender = [snapshot]() {
+        resolveTextures(snapshot->data, snapshot->textures);
+        ImGui_ImplOpenGL3_RenderDrawData(&snapshot->data);
+
+        // ImGui binds its own objects without going through the state cache
+        GL::invalidateState();
+    };
+
+    m_renderThread->endFrame();
 }
 
 void TestTransformable::run()
@@ -159,6 +828,32 @@ void TestTransformable::run()
 
     while(m_window.isOpen())
     {
+        // Only between two frames, the render thread gives the context back when it is destroyed
+        if(m_useRenderThread != static_cast<bool>(m_renderThread))
+        {
+            // The loader is only updated without the render thread, which restores the textures synchronously
+            if(m_useRenderThread)
+            {
+                TextureRegistry::getGlobal().setLoader(nullptr);
+            }
+
+            m_renderThread = m_useRenderThread ? std::make_unique<RenderThread>(m_window) : nullptr;
+            m_frameTimer.reset();
+
+            if(!m_renderThread)
+            {
+                TextureRegistry::getGlobal().setLoader(&m_textureLoader);
+            }
+        }
+
+        if(m_renderThread)
+        {
+            runThreadedFrame();
+            continue;
+        }
+
+        const Time start = Time::now();
+
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -171,42 +866,22 @@ void TestTransformable::run()
         draw();
 
         ImGui::Render();
+        resolveTextures(*ImGui::GetDrawData(), m_imguiTextures);
+        m_imguiTextures.clear();
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
+        // ImGui binds its own objects without going through the state cache
+        GL::invalidateState();
+
         m_window.display();
+        m_frameTimer.presented(start);
     }
 
+    m_renderThread = nullptr;
+
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplSDL2_Shutdown();
     ImGui::DestroyContext();
 
     exit(0);
 }
-
-void TestTransformable::drawGrid(RenderStates states)
-{
-    Line line;
-    glm::vec2 a, b;
-
-    const int count = 10;
-
-    // color
-    glm::vec4 axis{1, 0, 0, 1}, noaxis{1};
-
-    for(int x = -count; x <= count; ++x)
-    {
-        a = {x, -count};
-        b = {x, count};
-
-        line.update(a, b, x == 0 ? axis : noaxis);
-        line.draw(states);
-    }
-
-    for(int y = -count; y <= count; ++y)
-    {
-        a = {-count, y};
-        b = {count, y};
-        line.update(a, b, y == 0 ? axis : noaxis);
-        line.draw(states);
-    }
-}
@@ -1,9 +1,20 @@
 #include "media/Window.hpp"
+#include "media/RenderThread.hpp"
 #include <wrappers/gl/RenderStates.hpp>
+#include <wrappers/gl/Renderer.hpp>
 #include <wrappers/gl/Shape.hpp>
 #include <wrappers/gl/ConvexShape.hpp>
 #include <wrappers/gl/Circle.hpp>
+#include <wrappers/gl/Grid.hpp>
+#include <wrappers/gl/ShapeInstances.hpp>
+#include <wrappers/gl/SpatialIndex.hpp>
+#include <wrappers/gl/Sprite.hpp>
+#include <wrappers/gl/TextureLoader.hpp>
 #include <wrappers/freetype/Text.hpp>
+#include <utility/ThreadPool.hpp>
+#include <utility/time/Time.hpp>
+#include <deque>
+#include <memory>
 
 /// @brief Test transformable with a IMGUI interface
 class TestTransformable
@@ -16,14 +27,38 @@ public:
 protected:
     void draw();
 
-    void drawGrid(RenderStates states);
+    /// @brief Prepare a frame and hand it to the render thread.
+    void runThreadedFrame();
+
+    /// @brief Replace the instanced circles by a grid of side x side circles.
+    void setCircleGrid(int side);
+
+    /// @brief Replace the crowd by count sprites, drawn with Renderer::record().
+    void setCrowd(int count);
+
+    /// @brief Compare the bulk transform computation of TransformStore with the glm matrix products.
+    void benchmarkTransforms();
+
+    /// @brief Compare the outline kernel with the previous acos/tan implementation.
+    void benchmarkOutline();
+
+    /// @brief Compare the queries of SpatialGrid with a linear scan of all the rects.
+    void benchmarkSpatialIndex();
 
 private:
     Window m_window;
+    std::unique_ptr<RenderThread> m_renderThread; ///< Not null when the frames are rendered on a dedicated thread
+    bool m_useRenderThread{false};
+    FrameTimer m_frameTimer; ///< Without the render thread
     Shader m_shader;
+    Renderer m_renderer;
+    bool m_batching{true};
+    int m_vertexFormat{0}; ///< Vertex::Format
+    bool m_indexed{false}; ///< Shape::setIndexed()
+    bool m_culling{true}; ///< RenderStates::culling
 
     float m_zoom{3.0f};
-    float m_gridRadius{10.0f};
+    Grid m_grid;
 
     glm::vec2 m_origin{0.0f};
     glm::vec4 m_position{0.0f};
@@ -36,8 +71,26 @@ private:
 
     ConvexShape m_triangle;
     Circle m_circle;
+    ShapeInstances<Circle> m_circles;
+    int m_circleSide{32}; ///< The instanced circles are a square grid
+    bool m_sdf{false}; ///< Circle::Mode::SDF
     Text m_text;
     Drawable *m_current{&m_triangle};
+    SpatialIndex<Shape> m_pickIndex; ///< To find the shapes under the mouse
+
+    std::deque<Sprite> m_crowd; ///< Sprites are not movable
+    std::vector<const Drawable*> m_crowdDrawables;
+    int m_crowdSize{10000};
+    bool m_parallelRecording{true};
+    Time m_crowdTime; ///< Time to submit the crowd to the renderer
+
+    TextureLoader m_textureLoader;
+    std::filesystem::path m_imagePath;
+    std::vector<std::shared_ptr<Texture>> m_textures; ///< Displayed as thumbnails
+    std::vector<std::shared_ptr<Texture>> m_imguiTextures; ///< Given to ImGui::Image() this frame, see resolveTextures()
+    int m_textureCount{200};
+    Time m_textureLoadTime; ///< Time to load the textures synchronously, or to start loading them
+    std::string m_textureError; ///< Message of the last loading error
 
     Font m_font;
 
@@ -46,4 +99,19 @@ private:
     bool m_noOutline{false};
 
     Vertex m_triangleVertices[3];
+
+    ThreadPool m_threadPool;
+
+    TransformStore m_benchmarkStore;
+    std::vector<glm::mat3> m_benchmarkMatrices;
+    int m_benchmarkCount{100000};
+
+    std::vector<Vertex> m_benchmarkPolygon;
+    std::vector<glm::vec2> m_benchmarkOutline;
+    int m_benchmarkPolygonSize{200000};
+
+    SpatialGrid m_benchmarkGrid{2.0f};
+    std::vector<Rect> m_benchmarkRects;
+    int m_benchmarkRectCount{100000};
+    Time m_benchmarkGridTime; ///< Time to insert all the rects
 };
\ No newline at end of file
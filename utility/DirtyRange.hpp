@@ -0,0 +1,70 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+
+/// @brief Range of modified elements of an array, to only upload what changed.
+/// @details The range is [begin, end[. Modifying two distant elements marks all the elements between them.
+struct DirtyRange
+{
+    std::size_t begin{0};
+    std::size_t end{0};
+
+    bool empty() const
+    {
+        return begin >= end;
+    }
+
+    void clear()
+    {
+        begin = end = 0;
+    }
+
+    void add(std::size_t index)
+    {
+        add(index, index + 1);
+    }
+
+    /// @brief Mark [first, last[ as modified.
+    void add(std::size_t first, std::size_t last)
+    {
+        if(first >= last)
+        {
+            return;
+        }
+
+        if(empty())
+        {
+            begin = first;
+            end = last;
+        }
+        else
+        {
+            begin = std::min(begin, first);
+            end = std::max(end, last);
+        }
+    }
+
+    /// @brief Mark the elements that differ between two versions of an array.
+    /// @details If the sizes are different, all the elements of current are marked.
+    template<typename T>
+    void addChanges(std::span<const T> previous, std::span<const T> current)
+    {
+        if(previous.size() != current.size())
+        {
+            add(0, current.size());
+            return;
+        }
+
+        const auto first = std::mismatch(current.begin(), current.end(), previous.begin()).first;
+
+        if(first != current.end())
+        {
+            // Search the last difference from the end
+            const auto last = std::mismatch(current.rbegin(), current.rend(), previous.rbegin()).first;
+
+            add(static_cast<std::size_t>(first - current.begin()), static_cast<std::size_t>(current.rend() - last));
+        }
+    }
+};
@@ -0,0 +1,157 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <exception>
+#include <memory>
+
+namespace
+{
+    thread_local bool worker = false;
+}
+
+ThreadPool::ThreadPool(unsigned int workerCount)
+{
+    m_workers.reserve(workerCount);
+
+    for(unsigned int i = 0; i < workerCount; ++i)
+    {
+        m_workers.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+
+    m_condition.notify_all();
+
+    for(std::thread& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::getGlobal()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+unsigned int ThreadPool::getDefaultWorkerCount()
+{
+    // hardware_concurrency() can return 0 if it is not computable
+    const unsigned int cores = std::thread::hardware_concurrency();
+    return cores > 1 ? cores - 1 : 1;
+}
+
+bool ThreadPool::isWorker()
+{
+    return worker;
+}
+
+unsigned int ThreadPool::getConcurrency() const
+{
+    return static_cast<unsigned int>(m_workers.size()) + 1;
+}
+
+std::future<void> ThreadPool::submit(std::function<void()> task)
+{
+    // std::function needs to be copyable, packaged_task is not
+    auto packaged = std::make_shared<std::packaged_task<void()>>(std::move(task));
+    std::future<void> future = packaged->get_future();
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_tasks.emplace([packaged]() { (*packaged)(); });
+    }
+
+    m_condition.notify_one();
+
+    return future;
+}
+
+void ThreadPool::parallelFor(std::size_t count, const std::function<void(std::size_t, std::size_t)>& func,
+                             std::size_t grain)
+{
+    if(count == 0)
+    {
+        return;
+    }
+
+    if(worker)
+    {
+        func(0, count);
+        return;
+    }
+
+    grain = std::max<std::size_t>(grain, 1);
+
+    // Ranges size rounded up to the grain
+    const std::size_t grains = (count + grain - 1) / grain;
+    const std::size_t rangeCount = std::min<std::size_t>(getConcurrency(), grains);
+    const std::size_t rangeSize = (grains + rangeCount - 1) / rangeCount * grain;
+
+    std::vector<std::future<void>> futures;
+    futures.reserve(rangeCount);
+
+    // The first range is for the calling thread
+    for(std::size_t begin = rangeSize; begin < count; begin += rangeSize)
+    {
+        const std::size_t end = std::min(begin + rangeSize, count);
+        futures.push_back(submit([&func, begin, end]() { func(begin, end); }));
+    }
+
+    std::exception_ptr error;
+
+    try
+    {
+        func(0, std::min(rangeSize, count));
+    }
+    catch(...)
+    {
+        error = std::current_exception();
+    }
+
+    // All the tasks should be finished before returning or throwing, since they reference func
+    for(std::future<void>& future : futures)
+    {
+        future.wait();
+    }
+
+    if(error)
+    {
+        std::rethrow_exception(error);
+    }
+
+    for(std::future<void>& future : futures)
+    {
+        future.get();
+    }
+}
+
+void ThreadPool::work()
+{
+    worker = true;
+
+    while(true)
+    {
+        std::function<void()> task;
+
+        {
+            std::unique_lock lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_stop || !m_tasks.empty(); });
+
+            if(m_stop && m_tasks.empty())
+            {
+                return;
+            }
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop();
+        }
+
+        task();
+    }
+}
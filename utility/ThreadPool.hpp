@@ -0,0 +1,59 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/// @brief Fixed count of worker threads executing tasks from a shared queue.
+/// @details The workers are started in the constructor and joined in the destructor, after the remaining tasks
+/// are finished.
+class ThreadPool
+{
+public:
+    /// @param workerCount The count of worker threads. By default, one less than the count of cores, since the
+    /// thread calling parallelFor() also works.
+    explicit ThreadPool(unsigned int workerCount = getDefaultWorkerCount());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// @brief Get the pool shared by the classes that parallelize their work internally, like Shape.
+    /// @details Started at the first call, with the default count of workers.
+    static ThreadPool& getGlobal();
+
+    /// @brief Run a task asynchronously on a worker.
+    /// @returns A future to wait for the task, it also holds the exception thrown by the task if there is one.
+    std::future<void> submit(std::function<void()> task);
+
+    /// @brief Split [0, count) in contiguous ranges and call func(begin, end) on each of them in parallel.
+    /// @details Blocks until all the ranges are processed. The calling thread processes one of the ranges.
+    /// If called from a worker of any pool, the whole range is processed by the calling thread: the other workers may
+    /// all be waiting for their own nested tasks, which would never be executed.
+    /// @param grain The size of the ranges is always a multiple of grain, except for the last one.
+    /// @throws The first exception thrown by func, if any.
+    void parallelFor(std::size_t count, const std::function<void(std::size_t, std::size_t)>& func,
+                     std::size_t grain = 1);
+
+    /// @returns The count of threads working in parallelFor(), the workers plus the calling thread.
+    unsigned int getConcurrency() const;
+
+    static unsigned int getDefaultWorkerCount();
+
+    /// @returns If the calling thread is a worker of a pool.
+    static bool isWorker();
+
+private:
+    void work();
+
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::queue<std::function<void()>> m_tasks;
+    bool m_stop{false};
+};
@@ -1,16 +1,18 @@
 #pragma once
 
 #include <wrappers/gl/Texture.hpp>
+#include <utility/Rect.hpp>
 #include <glm/vec2.hpp>
 
 struct Glyph
 {
-    Texture texture; ///< Texture representing the character
+    const Texture *texture{nullptr}; ///< Atlas page containing the character, owned by the Font
 
-    glm::vec2 size; ///< Texture size in pixel, Should be the same as the texture size
+    Rect textureRect; ///< Area of the character in the atlas page, in UV coordinates
+
+    glm::vec2 size; ///< Texture size in pixel
 
     glm::vec2 bearing; ///< Bearing in pixel
 
     float advance; ///< Advance, in pixel
 };
-
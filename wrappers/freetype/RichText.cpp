@@ -1,52 +1,38 @@
 #include "RichText.hpp"
-#include <glm/gtc/matrix_transform.hpp>
+#include <wrappers/gl/Renderer.hpp>
+#include <wrappers/freetype/Text.hpp>
+#include <algorithm>
+#include <iterator>
+#include <span>
 
 RichText::RichText()
     : m_font(nullptr)
 {
-    m_sprite.setOrigin({-0.5f, 0.5f});
 }
 
 void RichText::push(const RichSegment& segment)
 {
     m_segments.push_back(segment);
+    m_needUpdate = true;
 }
 
-void RichText::draw(RenderStates states) const
+const Rect& RichText::getLocalBounds() const
 {
-    states.model *= getTransform();
-
-    // Cursor in pixel, advance with each letter
-    // Bottom-Left of the current character (plus padding)
-    glm::vec2 advance{0.0f, 0.0f};
-
-    for(const RichSegment& segment : m_segments)
+    if(needUpdate())
     {
-        switch(segment.data.index())
-        {
-            case 0:
-                // SegmentIcon
-                drawIcon(states, advance, std::get<RichSegment::SegmentIcon>(segment.data));
-                break;
-
-            case 1:
-                // std::string
-                drawString(states, advance, std::get<std::string>(segment.data));
-                break;
-        }
+        update();
     }
+
+    return m_localBounds;
 }
 
-void RichText::setFont(const Font *font)
+const Rect& RichText::getGlobalBounds() const
 {
-    m_font = font;
+    return m_globalBounds.get(*this, getLocalBounds());
 }
 
-void RichText::drawIcon(RenderStates states, glm::vec2& advance, const RichSegment::SegmentIcon& icon) const
+glm::vec2 RichText::getIconSize(const RichSegment::SegmentIcon& icon, const Glyph& glyph) const
 {
-    const Glyph& glyph = m_font->getGlyph(icon.model);
-    m_sprite.setTexture(icon.texture);
-
     // gx?
     // gx/gy = tx/ty
     // <=> gx =tx/ty*gy
@@ -55,36 +41,159 @@ void RichText::drawIcon(RenderStates states, glm::vec2& advance, const RichSegme
     size.y = glyph.size.y;
     size.x = static_cast<float>(icon.texture->getSize().x) / icon.texture->getSize().y * glyph.size.y;
 
-    states.model = glm::translate(states.model, {advance + glyph.bearing, 0.0f});
-    states.model = glm::scale(states.model, {size, 1.0f});
+    return size;
+}
 
-    m_sprite.draw(states);
+bool RichText::needUpdate() const
+{
+    if(m_needUpdate)
+    {
+        return true;
+    }
 
-    // Also add to the offset the difference between the model glyph and the icon glyph size
-    advance.x += glyph.advance + (size.x - glyph.size.x);
+    return std::any_of(m_icons.begin(), m_icons.end(), [](const BuiltIcon& icon) {
+        return icon.texture->getSize() != icon.size;
+    });
 }
 
-void RichText::drawString(RenderStates states, glm::vec2& advance, const std::string& str) const
+void RichText::update() const
 {
-    for(char c : str)
+    m_needUpdate = false;
+    m_vertices.clear();
+    m_pages.clear();
+    m_icons.clear();
+
+    if(m_font)
     {
-        const Glyph& glyph = m_font->getGlyph(c);
-        m_sprite.setTexture(&glyph.texture);
+        // Quads of each page, to be concatenated after so that each page is a contiguous range
+        std::vector<std::vector<Vertex>> quads;
+
+        auto append = [&](const Glyph& glyph, const glm::vec2& cursor, bool text) {
+            auto page = std::find_if(m_pages.begin(), m_pages.end(), [&](const Page& p) {
+                return p.texture == glyph.texture && p.text == text;
+            });
+
+            if(page == m_pages.end())
+            {
+                m_pages.push_back({glyph.texture, text, 0, 0});
+                quads.emplace_back();
+                page = std::prev(m_pages.end());
+            }
+
+            Text::appendQuad(quads[page - m_pages.begin()], cursor, glyph, glm::vec4{1.0f});
+        };
+
+        // Cursor in pixel, advance with each letter
+        // Bottom-Left of the current character (plus padding)
+        glm::vec2 cursor{0.0f, 0.0f};
+
+        for(const RichSegment& segment : m_segments)
+        {
+            if(const auto *icon = std::get_if<RichSegment::SegmentIcon>(&segment.data))
+            {
+                const Glyph& glyph = m_font->getGlyph(icon->model);
+
+                // The whole texture, placed like the model glyph but with the size of the icon
+                Glyph quad = glyph;
+                quad.texture = icon->texture;
+                quad.textureRect = Rect{{1.0f, 1.0f}, {0.5f, 0.5f}};
+                quad.size = getIconSize(*icon, glyph);
+
+                append(quad, cursor, false);
+                m_icons.push_back({icon->texture, icon->texture->getSize()});
+
+                // Also add to the offset the difference between the model glyph and the icon glyph size
+                cursor.x += glyph.advance + (quad.size.x - glyph.size.x);
+            }
+            else
+            {
+                for(char c : std::get<std::string>(segment.data))
+                {
+                    const Glyph& glyph = m_font->getGlyph(c);
+
+                    if(glyph.size.x > 0.0f && glyph.size.y > 0.0f)
+                    {
+                        append(glyph, cursor, true);
+                    }
+
+                    cursor.x += glyph.advance;
+                }
+            }
+        }
 
-        drawGlyph(states, advance, glyph);
+        for(std::size_t i = 0; i < m_pages.size(); ++i)
+        {
+            m_pages[i].first = static_cast<GLint>(m_vertices.size());
+            m_pages[i].count = static_cast<GLsizei>(quads[i].size());
+            m_vertices.insert(m_vertices.end(), quads[i].begin(), quads[i].end());
+        }
     }
+
+    m_localBounds = Bounds::compute(m_vertices);
+    m_globalBounds.invalidate();
+
+    m_needUpload = true;
 }
 
-void RichText::drawGlyph(RenderStates states, glm::vec2& advance, const Glyph& glyph) const
+void RichText::upload() const
 {
-    // Text rendering is a special case, we don't want to scale to a specific size,
-    // but rather render the exact size of the glyph because font, in many cases, is not done to be scaled
-    states.model = glm::translate(states.model, {advance + glyph.bearing, 0.0f});
-    states.model = glm::scale(states.model, {glyph.size, 1.0f});
+    GL::bindVertexArray(m_vao);
+    GL::bindBuffer(GL_ARRAY_BUFFER, m_vbo);
 
-    m_sprite.draw(states);
+    GL::bufferData(GL_ARRAY_BUFFER, m_vertices, GL_STATIC_DRAW);
+    Vertex::vertexAttribPointer();
+}
 
-    advance.x += glyph.advance;
+void RichText::draw(RenderStates states) const
+{
+    if(!states.shader || !Bounds::isVisible(states, getGlobalBounds()))
+    {
+        return;
+    }
+
+    states.model *= getTransform();
+
+    if(states.renderer)
+    {
+        for(const Page& page : m_pages)
+        {
+            auto vertices = std::span<const Vertex>(m_vertices).subspan(page.first, page.count);
+            states.renderer->draw(states, page.texture, GL_TRIANGLES, vertices, glm::vec4{1.0f}, page.text);
+        }
+
+        return;
+    }
+
+    if(m_needUpload)
+    {
+        m_needUpload = false;
+        upload();
+    }
+
+    Shader::bind(states.shader);
+
+    states.shader->setUniform("u_ModelMatrix", states.model);
+    states.shader->setUniform("u_ViewMatrix", states.view);
+    states.shader->setUniform("u_Color", glm::vec4{1.0f}); // The color is in the vertices
+
+    GL::bindVertexArray(m_vao);
+
+    for(const Page& page : m_pages)
+    {
+        states.shader->setUniform("u_Text", page.text);
+
+        Texture::bind(page.texture);
+        glDrawArrays(GL_TRIANGLES, page.first, page.count);
+    }
+
+    // Not used anywhere else so we should release the flag ourselves
+    states.shader->setUniform("u_Text", false);
+}
+
+void RichText::setFont(const Font *font)
+{
+    m_font = font;
+    m_needUpdate = true;
 }
 
 const Font* RichText::getFont() const
@@ -1,10 +1,14 @@
 #pragma once
 
-#include <wrappers/gl/Sprite.hpp>
+#include <wrappers/gl/Bounds.hpp>
+#include <wrappers/gl/Drawable.hpp>
+#include <wrappers/gl/Transformable.hpp>
+#include <wrappers/gl/Vertex.hpp>
 #include <wrappers/gl/Texture.hpp>
 #include <wrappers/freetype/Font.hpp>
 #include <glm/vec4.hpp>
 #include <variant>
+#include <vector>
 
 struct RichSegment
 {
@@ -25,6 +29,8 @@ struct RichSegment
 /// You can set style to individual characters or segments of text, and insert icons as textures like real character
 /// and customize their size. However, it does not define a language like css, you will either have to use this class
 /// directly or define your own css-like language.
+/// Like Text, the glyphs and icons are a single mesh of quads, rebuilt only when the segments or the font change, and
+/// drawn with one draw call per texture.
 class RichText : public Drawable, public Transformable
 {
 public:
@@ -39,14 +45,54 @@ public:
     /// The font should not not be null.
     void push(const RichSegment& segment);
 
+    /// @brief Get the bounding box of the glyphs and icons, in pixel.
+    const Rect& getLocalBounds() const;
+
+    /// @brief Get the bounding box in the space of the parent, with the transformation.
+    const Rect& getGlobalBounds() const;
+
 private:
-    void drawString(RenderStates states, glm::vec2& advance, const std::string& str) const;
-    void drawIcon(RenderStates states, glm::vec2& advance, const RichSegment::SegmentIcon& icon) const;
-    void drawGlyph(RenderStates states, glm::vec2& advance, const Glyph& glyph) const;
+    /// @brief Range of the mesh using the same texture.
+    struct Page
+    {
+        const Texture *texture;
+        bool text; ///< Glyphs of an atlas page, or icons
+        GLint first;
+        GLsizei count;
+    };
+
+    /// @brief An icon of the mesh, with the size of its texture when the mesh was built.
+    struct BuiltIcon
+    {
+        const Texture *texture;
+        glm::vec2 size;
+    };
+
+    /// @brief Get the size of an icon: the height of its model glyph, with the aspect ratio of its texture.
+    glm::vec2 getIconSize(const RichSegment::SegmentIcon& icon, const Glyph& glyph) const;
+
+    /// @returns If the mesh should be rebuilt, because it was invalidated or an icon texture was resized since.
+    /// @details The size of a texture changes when it is loaded asynchronously, see TextureLoader.
+    bool needUpdate() const;
+
+    /// @brief Build the mesh from the segments.
+    void update() const;
+
+    /// @brief Upload the mesh to the GPU buffer.
+    void upload() const;
 
     const Font *m_font;
     std::vector<RichSegment> m_segments;
 
-    mutable Sprite m_sprite;
-};
+    mutable std::vector<Vertex> m_vertices; ///< Glyph and icon quads, drawn as GL_TRIANGLES
+    mutable std::vector<Page> m_pages;
+    mutable std::vector<BuiltIcon> m_icons;
+    mutable bool m_needUpdate{true};
+    mutable bool m_needUpload{true};
+
+    mutable Rect m_localBounds;
+    mutable GlobalBounds m_globalBounds;
 
+    GL::VertexArray m_vao;
+    GL::Buffer m_vbo;
+};
@@ -1,12 +1,10 @@
 #include "Text.hpp"
-#include <glm/gtc/matrix_transform.hpp>
+#include <wrappers/gl/Renderer.hpp>
+#include <algorithm>
+#include <iterator>
+#include <span>
 
-Text::Text()
-{
-    // We need the origin of each char to be top left and not center
-    // It's because how FreeType handle bearing
-    m_sprite.setOrigin({-0.5f, 0.5f});
-}
+Text::Text() = default;
 
 void Text::setFont(const Font *font)
 {
@@ -21,8 +19,11 @@ const Font *Text::getFont() const
 
 void Text::setString(const std::string& string)
 {
-    m_string = string;
-    m_needUpdate = true;
+    if(m_string != string)
+    {
+        m_string = string;
+        m_needUpdate = true;
+    }
 }
 
 const std::string& Text::getString() const
@@ -32,8 +33,11 @@ const std::string& Text::getString() const
 
 void Text::setColor(const glm::vec4& color)
 {
-    m_color = color;
-    m_sprite.setColor(m_color);
+    if(m_color != color)
+    {
+        m_color = color;
+        m_needUpdate = true;
+    }
 }
 
 const glm::vec4& Text::getColor() const
@@ -52,9 +56,26 @@ glm::vec2 Text::getSize() const
     return m_size;
 }
 
+const Rect& Text::getLocalBounds() const
+{
+    if(m_needUpdate)
+    {
+        m_needUpdate = false;
+        update();
+    }
+
+    return m_localBounds;
+}
+
+const Rect& Text::getGlobalBounds() const
+{
+    return m_globalBounds.get(*this, getLocalBounds());
+}
+
 void Text::update() const
 {
-    m_glyphs = {};
+    m_vertices.clear();
+    m_pages.clear();
 
     if(!m_font)
     {
@@ -62,14 +83,41 @@ void Text::update() const
     }
     else
     {
+        // Quads of each atlas page, to be concatenated after so that each page is a contiguous range
+        std::vector<std::vector<Vertex>> quads;
+
+        // Cursor in pixel, advance with each letter
+        // Bottom-Left of the current character (plus padding)
         glm::vec2 cursor{0.0f, 0.0f};
 
         for (char c : m_string)
         {
             const Glyph& glyph = m_font->getGlyph(c);
-            m_glyphs.push_back(&glyph);
 
-            cursor += glyph.advance;
+            if(glyph.size.x > 0.0f && glyph.size.y > 0.0f)
+            {
+                auto page = std::find_if(m_pages.begin(), m_pages.end(), [&](const Page& p) {
+                    return p.texture == glyph.texture;
+                });
+
+                if(page == m_pages.end())
+                {
+                    m_pages.push_back({glyph.texture, 0, 0});
+                    quads.emplace_back();
+                    page = std::prev(m_pages.end());
+                }
+
+                appendQuad(quads[page - m_pages.begin()], cursor, glyph, m_color);
+            }
+
+            cursor.x += glyph.advance;
+        }
+
+        for(std::size_t i = 0; i < m_pages.size(); ++i)
+        {
+            m_pages[i].first = static_cast<GLint>(m_vertices.size());
+            m_pages[i].count = static_cast<GLsizei>(quads[i].size());
+            m_vertices.insert(m_vertices.end(), quads[i].begin(), quads[i].end());
         }
 
         // Only one line supported
@@ -77,6 +125,51 @@ void Text::update() const
 
         m_size = cursor;
     }
+
+    m_localBounds = Bounds::compute(m_vertices);
+    m_globalBounds.invalidate();
+
+    m_needUpload = true;
+}
+
+void Text::appendQuad(std::vector<Vertex>& vertices, const glm::vec2& cursor, const Glyph& glyph,
+                      const glm::vec4& color)
+{
+    // Text rendering is a special case, we don't want to scale to a specific size,
+    // but rather render the exact size of the glyph because font, in many cases, is not done to be scaled
+    // The bearing is the offset from the cursor to the top-left corner of the glyph
+    const float left = cursor.x + glyph.bearing.x;
+    const float right = left + glyph.size.x;
+    const float top = cursor.y + glyph.bearing.y;
+    const float bottom = top - glyph.size.y;
+
+    const Rect& uv = glyph.textureRect;
+
+    Vertex bottomLeft({left, bottom}, color);
+    bottomLeft.uv = uv.bottomLeft();
+
+    Vertex bottomRight({right, bottom}, color);
+    bottomRight.uv = uv.bottomRight();
+
+    Vertex topRight({right, top}, color);
+    topRight.uv = uv.topRight();
+
+    Vertex topLeft({left, top}, color);
+    topLeft.uv = uv.topLeft();
+
+    vertices.insert(vertices.end(), {
+        bottomLeft, bottomRight, topRight,
+        bottomLeft, topRight, topLeft
+    });
+}
+
+void Text::upload() const
+{
+    GL::bindVertexArray(m_vao);
+    GL::bindBuffer(GL_ARRAY_BUFFER, m_vbo);
+
+    GL::bufferData(GL_ARRAY_BUFFER, m_vertices, GL_STATIC_DRAW);
+    Vertex::vertexAttribPointer();
 }
 
 void Text::draw(RenderStates states) const
@@ -89,34 +182,47 @@ void Text::draw(RenderStates states) const
 
     if(states.shader)
     {
+        if(!Bounds::isVisible(states, getGlobalBounds()))
+        {
+            return;
+        }
+
         states.model *= getTransform();
 
-        states.shader->bind();
-        states.shader->setUniform("u_Text", true);
+        if(states.renderer)
+        {
+            for(const Page& page : m_pages)
+            {
+                auto vertices = std::span<const Vertex>(m_vertices).subspan(page.first, page.count);
+                states.renderer->draw(states, page.texture, GL_TRIANGLES, vertices, glm::vec4{1.0f}, true);
+            }
 
-        // Cursor in pixel, advance with each letter
-        // Bottom-Left of the current character (plus padding)
-        glm::vec2 cursor{0.0f, 0.0f};
+            return;
+        }
 
-        for (const Glyph *glyph : m_glyphs)
+        if(m_needUpload)
         {
-            m_sprite.setTexture(&glyph->texture);
+            m_needUpload = false;
+            upload();
+        }
+
+        Shader::bind(states.shader);
 
-            // Text rendering is a special case, we don't want to scale to a specific size,
-            // but rather render the exact size of the glyph because font, in many cases, is not done to be scaled
-            RenderStates states2 = states;
-            states2.model = glm::translate(states2.model, {cursor + glyph->bearing, 0.0f});
-            states2.model = glm::scale(states2.model, {glyph->size, 1.0f});
+        states.shader->setUniform("u_Text", true);
+        states.shader->setUniform("u_ModelMatrix", states.model);
+        states.shader->setUniform("u_ViewMatrix", states.view);
+        states.shader->setUniform("u_Color", glm::vec4{1.0f}); // The color is in the vertices
 
-            m_sprite.draw(states2);
+        GL::bindVertexArray(m_vao);
 
-            cursor.x += glyph->advance;
+        // Usually all the glyphs are in the same page, so it is a single draw call
+        for(const Page& page : m_pages)
+        {
+            Texture::bind(page.texture);
+            glDrawArrays(GL_TRIANGLES, page.first, page.count);
         }
 
         // Not used anywhere else so we should release the flag ourselves
         states.shader->setUniform("u_Text", false);
     }
 }
-
-
-
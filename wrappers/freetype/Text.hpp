@@ -1,12 +1,18 @@
 #pragma once
 
-#include <wrappers/gl/Sprite.hpp>
+#include <wrappers/gl/Bounds.hpp>
+#include <wrappers/gl/Drawable.hpp>
+#include <wrappers/gl/Transformable.hpp>
+#include <wrappers/gl/Vertex.hpp>
 #include <wrappers/gl/Texture.hpp>
 #include <wrappers/freetype/Font.hpp>
 #include <glm/vec4.hpp>
+#include <vector>
 
 /// @brief The renderable part of Font, the String itself.
 /// @details Wrap a texture of text.
+/// The whole string is a single mesh of glyph quads, rebuilt only when the string, the font or the color changes.
+/// Drawing it is one draw call per atlas page used by the string, so usually only one.
 /// @remarks If not scaled, the unit size of the Text is the pixel.
 class Text : public Drawable, public Transformable
 {
@@ -28,16 +34,45 @@ public:
     /// @brief Get the size of full text, in pixel.
     glm::vec2 getSize() const;
 
+    /// @brief Get the bounding box of the glyphs, in pixel.
+    /// @details Unlike getSize(), only the visible part of the glyphs, from their bearing.
+    const Rect& getLocalBounds() const;
+
+    /// @brief Get the bounding box in the space of the parent, with the transformation.
+    const Rect& getGlobalBounds() const;
+
+    /// @brief Append the two triangles of a glyph.
+    /// @param cursor The position of the glyph on the baseline, in pixel.
+    static void appendQuad(std::vector<Vertex>& vertices, const glm::vec2& cursor, const Glyph& glyph,
+                           const glm::vec4& color);
+
 private:
-    /// @brief Update the glyph and the sprite based on the font, string and color.
+    /// @brief Range of the mesh using the same atlas page.
+    struct Page
+    {
+        const Texture *texture;
+        GLint first;
+        GLsizei count;
+    };
+
+    /// @brief Update the mesh based on the font, string and color.
     void update() const;
 
+    /// @brief Upload the mesh to the GPU buffer.
+    void upload() const;
+
     const Font *m_font{nullptr};
     std::string m_string;
     glm::vec4 m_color{glm::vec4(1.0f)};
 
-    mutable std::vector<const Glyph*> m_glyphs; ///< String converted to glyphs
-    mutable Sprite m_sprite; ///< Sprite to draw the text
+    mutable std::vector<Vertex> m_vertices; ///< Glyph quads, drawn as GL_TRIANGLES
+    mutable std::vector<Page> m_pages;
     mutable bool m_needUpdate{true};
+    mutable bool m_needUpload{true};
     mutable glm::vec2 m_size{0.0f};
-};
\ No newline at end of file
+    mutable Rect m_localBounds;
+    mutable GlobalBounds m_globalBounds;
+
+    GL::VertexArray m_vao;
+    GL::Buffer m_vbo;
+};
@@ -1,8 +1,6 @@
 #include "FontImpl.hpp"
 #include <wrappers/gl/GL.hpp>
 #include <wrappers/SDL.hpp>
-#include <vector>
-#include <algorithm>
 #include <iostream>
 
 #define FT_Check(call) do { int error = (call); if(error) { throw FTException(error, #call " failed"); } } while(0)
@@ -32,6 +30,7 @@ void FontImpl::reset()
 
     m_lineHeight = 0.0f;
     m_chars.clear();
+    m_atlas.clear();
 }
 
 void FontImpl::load(const std::filesystem::path& fontPath, int characterSize)
@@ -90,31 +89,14 @@ const Glyph& FontImpl::getGlyph(char c)
 
         // pitch = number of bytes for each row, pixels are always row major
         // however, the flow of the image (Y origin) can be top or down.
-        // if pitch > 0, the 'flow' is to down, origin=up => We need to reverse Y
+        // if pitch > 0, the 'flow' is to down, origin=up => The atlas reverses Y while copying
         // if pitch < 0, the 'flow' is to up, origin=down => How OpenGL treats texture (Textures origin is bottom-left corner)
 
         FT_Bitmap& bitmap = m_face->glyph->bitmap;
 
-        if(bitmap.pitch > 0)
-        {
-            // Not ok, need to reverse the texture
-
-            reverseBitmap(bitmap);
-        }
-
-        glyph.texture.bind();
-
-        // disable byte-alignment restriction
-        // texture should be multiple of 4 by default, but glyphs are greyscale so it could be of any size (= multiple of 1)
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, bitmap.width, bitmap.rows, 0, GL_RED, GL_UNSIGNED_BYTE, bitmap.buffer);
-
-        // Texture generic options
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        const GlyphAtlas::Region region = m_atlas.insert(bitmap.buffer, bitmap.width, bitmap.rows, bitmap.pitch);
+        glyph.texture = region.texture;
+        glyph.textureRect = region.textureRect;
 
         glyph.size = {bitmap.width, bitmap.rows};
 
@@ -130,23 +112,6 @@ const Glyph& FontImpl::getGlyph(char c)
     return m_chars.at(c);
 }
 
-void FontImpl::reverseBitmap(FT_Bitmap& bitmap)
-{
-    std::vector<unsigned char> rowBuffer(bitmap.pitch); // Temporary buffer to store the row
-
-    for(int row = 0; row < bitmap.rows / 2; ++row)
-    {
-        // Flip each row
-        // rows / 2 round to lower, so if there is a odd number of row the center row will not be swapped
-        // which is ok because it do not need to
-
-        unsigned char *row1 = bitmap.buffer + bitmap.pitch * row;
-        unsigned char *row2 = bitmap.buffer + bitmap.pitch * (bitmap.rows - 1 - row);
-
-        std::swap_ranges(row1, row1 + bitmap.pitch, row2);
-    }
-}
-
 float FontImpl::getLineHeight() const
 {
     return m_lineHeight;
@@ -2,6 +2,7 @@
 
 #include <wrappers/freetype/FTException.hpp>
 #include <wrappers/freetype/Glyph.hpp>
+#include <wrappers/freetype/private/GlyphAtlas.hpp>
 #include <wrappers/gl/Texture.hpp>
 #include <SDL2/SDL_version.h>
 #include <ft2build.h>
@@ -28,12 +29,11 @@ private:
     /// @brief Free memory
     void reset();
 
-    static void reverseBitmap(FT_Bitmap& bitmap);
-
     float m_lineHeight = 0.0f; ///< Font height in pixel.
     FT_Library m_ft = nullptr;
     FT_Face m_face = nullptr;
 
     std::map<char, Glyph> m_chars;
+    GlyphAtlas m_atlas; ///< Textures of the glyphs
 };
 
@@ -0,0 +1,100 @@
+#include "GlyphAtlas.hpp"
+#include <utility/Exception.hpp>
+#include <utility/Str.hpp>
+#include <cstdlib>
+#include <cstring>
+
+// Dear ImGui also compiles stb_rectpack with static linkage, so we need our own copy
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include <imstb_rectpack.h>
+
+GlyphAtlas::Page::Page()
+    : nodes(pageSize), pixels(pageSize * pageSize, 0)
+{
+    stbrp_init_target(&context, pageSize, pageSize, nodes.data(), static_cast<int>(nodes.size()));
+
+    // Rows of GL_RED are not a multiple of 4 bytes
+    GL::pixelStore(GL_UNPACK_ALIGNMENT, 1);
+    texture.create({pageSize, pageSize}, GL_RED, pixels.data());
+
+    // Texture generic options
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+GlyphAtlas::Region GlyphAtlas::insert(const unsigned char *pixels, int width, int rows, int pitch)
+{
+    if(m_pages.empty())
+    {
+        m_pages.push_back(std::make_unique<Page>());
+    }
+
+    Region region;
+
+    if(width == 0 || rows == 0)
+    {
+        // Nothing to draw (for example a space), but keep a texture to not break batches
+        region.texture = &m_pages.back()->texture;
+        return region;
+    }
+
+    stbrp_rect rect{};
+    rect.w = static_cast<stbrp_coord>(width + padding);
+    rect.h = static_cast<stbrp_coord>(rows + padding);
+
+    if(!stbrp_pack_rects(&m_pages.back()->context, &rect, 1))
+    {
+        // The last page is full, pack in a new one
+        m_pages.push_back(std::make_unique<Page>());
+
+        if(!stbrp_pack_rects(&m_pages.back()->context, &rect, 1))
+        {
+            throw Exception(Str{} << "Glyph of " << width << "x" << rows << "px does not fit in an atlas page");
+        }
+    }
+
+    Page& page = *m_pages.back();
+
+    // Copy the rows into the page, bottom row first
+    const int stride = std::abs(pitch);
+
+    for(int row = 0; row < rows; ++row)
+    {
+        const int srcRow = pitch > 0 ? rows - 1 - row : row;
+
+        const unsigned char *src = pixels + stride * srcRow;
+        unsigned char *dst = page.pixels.data() + (rect.y + row) * pageSize + rect.x;
+
+        std::memcpy(dst, src, width);
+    }
+
+    upload(page, rect.x, rect.y, width, rows);
+
+    region.texture = &page.texture;
+    region.textureRect.size = glm::vec2{width, rows} / static_cast<float>(pageSize);
+    region.textureRect.center = (glm::vec2{rect.x, rect.y} + glm::vec2{width, rows} / 2.0f) / static_cast<float>(pageSize);
+
+    return region;
+}
+
+void GlyphAtlas::upload(const Page& page, int x, int y, int width, int rows)
+{
+    page.texture.bind();
+
+    // Read the area directly from the CPU page
+    GL::pixelStore(GL_UNPACK_ALIGNMENT, 1);
+    GL::pixelStore(GL_UNPACK_ROW_LENGTH, pageSize);
+
+    const unsigned char *pixels = page.pixels.data() + y * pageSize + x;
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, rows, GL_RED, GL_UNSIGNED_BYTE, pixels);
+
+    GL::pixelStore(GL_UNPACK_ROW_LENGTH, 0);
+}
+
+void GlyphAtlas::clear()
+{
+    m_pages.clear();
+}
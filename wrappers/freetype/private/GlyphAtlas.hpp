@@ -0,0 +1,57 @@
+#pragma once
+
+#include <wrappers/gl/Texture.hpp>
+#include <utility/Rect.hpp>
+#include <imstb_rectpack.h>
+#include <memory>
+#include <vector>
+
+/// @file Do not include this file, it is for internal use.
+
+/// @brief Texture atlas for the glyphs of a Font.
+/// @details
+/// The glyphs are packed into one or more GL_RED pages with the stb rectangle packer.
+/// A new page is added when a glyph does not fit in the last one.
+/// Each page keeps a copy of its pixels on the CPU, from where the glyphs are uploaded.
+class GlyphAtlas
+{
+public:
+    /// @brief Location of a glyph in the atlas.
+    struct Region
+    {
+        const Texture *texture{nullptr}; ///< The page containing the glyph.
+        Rect textureRect; ///< The area of the glyph in the page, in UV coordinates.
+    };
+
+    /// @brief Size of a page, in pixel.
+    static constexpr int pageSize = 512;
+
+    /// @brief Copy a greyscale 8-bits bitmap into the atlas.
+    /// @param pitch The count of bytes of a row. If positive, the first row in memory is the top of the bitmap,
+    /// the rows are flipped while copying because OpenGL textures origin is the bottom-left corner.
+    /// @throws If the bitmap is bigger than a page.
+    Region insert(const unsigned char *pixels, int width, int rows, int pitch);
+
+    /// @brief Remove all the pages.
+    void clear();
+
+private:
+    struct Page
+    {
+        Page();
+
+        Texture texture;
+        stbrp_context context;
+        std::vector<stbrp_node> nodes;
+        std::vector<unsigned char> pixels; ///< CPU copy of the page, row 0 is the bottom.
+    };
+
+    /// @brief Space between two glyphs, to not sample the neighbour glyphs with linear filtering.
+    static constexpr int padding = 1;
+
+    /// @brief Upload an area of the page to the texture.
+    static void upload(const Page& page, int x, int y, int width, int rows);
+
+    /// @remarks Pointers because the glyphs keep a pointer to the page texture.
+    std::vector<std::unique_ptr<Page>> m_pages;
+};
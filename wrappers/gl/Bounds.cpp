@@ -0,0 +1,102 @@
+#include "Bounds.hpp"
+#include "Renderer.hpp"
+#include "Transformable.hpp"
+#include <cmath>
+
+namespace Bounds
+{
+    Rect fromMinMax(const glm::vec2& min, const glm::vec2& max)
+    {
+        return Rect{max - min, (min + max) / 2.0f};
+    }
+
+    Rect compute(std::span<const Vertex> vertices)
+    {
+        if(vertices.empty())
+        {
+            return Rect{};
+        }
+
+        glm::vec2 min{vertices.front().pos};
+        glm::vec2 max{min};
+
+        for(const Vertex& vertex : vertices)
+        {
+            min = glm::min(min, vertex.pos);
+            max = glm::max(max, vertex.pos);
+        }
+
+        return fromMinMax(min, max);
+    }
+
+    Rect merge(const Rect& a, const Rect& b)
+    {
+        return fromMinMax(glm::min(a.bottomLeft(), b.bottomLeft()), glm::max(a.topRight(), b.topRight()));
+    }
+
+    Rect transform(const Rect& rect, const glm::mat4& matrix)
+    {
+        // The transformed center plus the half-extent of the transformed box, with the absolute values of the
+        // linear part: same as transforming the four corners, but without the min/max
+        const glm::vec2 center{matrix * glm::vec4{rect.center, 0.0f, 1.0f}};
+        const glm::vec2 half = rect.size / 2.0f;
+
+        const glm::vec2 extent{
+            std::abs(matrix[0][0]) * half.x + std::abs(matrix[1][0]) * half.y,
+            std::abs(matrix[0][1]) * half.x + std::abs(matrix[1][1]) * half.y
+        };
+
+        return Rect{2.0f * extent, center};
+    }
+
+    bool intersects(const Rect& a, const Rect& b)
+    {
+        return a.left() <= b.right() && b.left() <= a.right() && a.bottom() <= b.top() && b.bottom() <= a.top();
+    }
+
+    bool isVisible(const RenderStates& states, const Rect& bounds)
+    {
+        bool visible = true;
+
+        if(states.culling)
+        {
+            // The view is an orthographic projection, so the clip space is affine to the world
+            static const Rect clipSpace{{2.0f, 2.0f}};
+            visible = intersects(transform(bounds, states.view * states.model), clipSpace);
+        }
+
+        if(states.renderer)
+        {
+            states.renderer->countObject(visible);
+        }
+
+        return visible;
+    }
+}
+
+GlobalBounds::GlobalBounds(const GlobalBounds&)
+{
+}
+
+GlobalBounds& GlobalBounds::operator=(const GlobalBounds&)
+{
+    invalidate();
+    return *this;
+}
+
+void GlobalBounds::invalidate()
+{
+    m_valid = false;
+}
+
+const Rect& GlobalBounds::get(const Transformable& transformable, const Rect& localBounds) const
+{
+    if(!m_valid || m_version != transformable.getVersion())
+    {
+        m_bounds = Bounds::transform(localBounds, transformable.getTransform());
+        m_version = transformable.getVersion();
+        m_valid = true;
+    }
+
+    return m_bounds;
+}
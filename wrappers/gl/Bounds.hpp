@@ -0,0 +1,55 @@
+#pragma once
+
+#include "RenderStates.hpp"
+#include "Vertex.hpp"
+#include <utility/Rect.hpp>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <span>
+
+class Transformable;
+
+/// @brief Axis-aligned bounding boxes, and culling of the drawables against the view.
+namespace Bounds
+{
+    Rect fromMinMax(const glm::vec2& min, const glm::vec2& max);
+
+    /// @returns The smallest Rect containing all the positions, an empty Rect in (0, 0) if there are no vertices.
+    Rect compute(std::span<const Vertex> vertices);
+
+    /// @returns The smallest Rect containing both rects.
+    Rect merge(const Rect& a, const Rect& b);
+
+    /// @returns The bounds of the transformed rect, which is not axis-aligned anymore if there is a rotation.
+    Rect transform(const Rect& rect, const glm::mat4& matrix);
+
+    bool intersects(const Rect& a, const Rect& b);
+
+    /// @brief The culling pass, to be called by the drawables before any GL work.
+    /// @param bounds The bounds in the space of states.model, usually the global bounds of the drawable.
+    /// @returns If the bounds are at least partially inside the view (the clip space after states.view), or if
+    /// the culling is disabled in the states. The result is counted in the stats of states.renderer, if any.
+    bool isVisible(const RenderStates& states, const Rect& bounds);
+}
+
+/// @brief Cached bounds of a Transformable in the world, the space of its parent.
+/// @details Recomputed only when the Transformable was modified, or when the local bounds were invalidated.
+/// @remarks The cache is not copied, so a copied drawable computes its own bounds.
+class GlobalBounds
+{
+public:
+    GlobalBounds() = default;
+    GlobalBounds(const GlobalBounds&);
+    GlobalBounds& operator=(const GlobalBounds&);
+
+    /// @brief The local bounds changed.
+    void invalidate();
+
+    /// @param localBounds The bounds before the transformation, only read if the cache is invalid.
+    const Rect& get(const Transformable& transformable, const Rect& localBounds) const;
+
+private:
+    mutable Rect m_bounds;
+    mutable std::uint64_t m_version{0}; ///< Version of the Transformable when the bounds were computed.
+    mutable bool m_valid{false};
+};
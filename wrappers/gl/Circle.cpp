@@ -1,12 +1,119 @@
 #include "Circle.hpp"
+#include "Renderer.hpp"
+#include "VertexBuffer.hpp"
 #include <utility/math.hpp>
+#include <algorithm>
 #include <cmath>
+#include <mutex>
+#include <unordered_map>
 
 Circle::Circle(unsigned short pointCount)
-    : m_radius(1.0f), m_pointCount(pointCount)
+    : m_radius(1.0f), m_adaptive(pointCount == adaptive),
+      m_pointCount(pointCount == adaptive ? defaultPointCount : pointCount)
 {
 }
 
+void Circle::draw(RenderStates states) const
+{
+    if(m_mode == Mode::SDF)
+    {
+        drawSDF(states);
+        return;
+    }
+
+    if(m_adaptive)
+    {
+        const unsigned short pointCount = getAdaptivePointCount(states.view * states.model * getTransform(),
+                                                                states.viewport);
+
+        // Power of two, so it changes only when the size on the screen doubles or halves
+        if(pointCount != m_pointCount)
+        {
+            m_pointCount = pointCount;
+            needUpdate();
+        }
+    }
+
+    Shape::draw(states);
+}
+
+void Circle::drawSDF(RenderStates states) const
+{
+    if(!states.shader)
+    {
+        return;
+    }
+
+    if(!Bounds::isVisible(states, getGlobalBounds()))
+    {
+        return;
+    }
+
+    // Not batched, the uniforms are specific to the circle
+    if(states.renderer)
+    {
+        states.renderer->flush();
+    }
+
+    // Shared by all the circles, it never changes
+    static VertexBuffer quad;
+
+    if(quad.getCount() == 0)
+    {
+        quad.update(getQuadVertices());
+    }
+
+    states.model *= getTransform();
+
+    Shader::bind(states.shader);
+    Texture::bind(getTexture());
+
+    states.shader->setUniform("u_ModelMatrix", states.model);
+    states.shader->setUniform("u_ViewMatrix", states.view);
+    states.shader->setUniform("u_Color", getColor());
+    states.shader->setUniform("u_OutlineColor", getOutlineColor());
+    states.shader->setUniform("u_OutlineThickness", getOutlineThickness());
+    states.shader->setUniform("u_SDF", true);
+
+    // Fill and outline at once
+    quad.bind();
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    // Not used anywhere else so we should release the flag ourselves
+    states.shader->setUniform("u_SDF", false);
+}
+
+unsigned short Circle::getAdaptivePointCount(const glm::mat4& transform, glm::ivec2 viewport) const
+{
+    if(viewport == glm::ivec2{0})
+    {
+        const GL::Viewport& current = GL::getViewport();
+        viewport = {current.width, current.height};
+    }
+
+    // Radius in pixels: the longest axis of the transformed circle, from clip space to the viewport
+    const glm::vec2 halfViewport = glm::vec2(viewport) / 2.0f;
+    const glm::vec2 xAxis = glm::vec2(transform[0]) * halfViewport;
+    const glm::vec2 yAxis = glm::vec2(transform[1]) * halfViewport;
+    const float radius = m_radius * std::max(glm::length(xAxis), glm::length(yAxis));
+
+    if(radius <= m_tolerance)
+    {
+        return minPointCount;
+    }
+
+    // The distance between the middle of a side and the circle is r * (1 - cos(pi / n))
+    const float count = PI / std::acos(1.0f - m_tolerance / radius);
+
+    unsigned short pointCount = minPointCount;
+    while(pointCount < count && pointCount < maxPointCount)
+    {
+        pointCount *= 2;
+    }
+
+    return pointCount;
+}
+
 size_t Circle::getVerticesCount() const
 {
     return m_pointCount;
@@ -14,12 +121,82 @@ size_t Circle::getVerticesCount() const
 
 Vertex Circle::getVertex(int index) const
 {
-    // angle is in [0;2pi[
-    float angle = static_cast<float>(index) / static_cast<float>(m_pointCount) * TAU;
+    return Vertex{getUnitCircle(m_pointCount)[index] * m_radius};
+}
 
-    Vertex v;
-    v.pos.x = std::cos(angle) * m_radius;
-    v.pos.y = std::sin(angle) * m_radius;
+void Circle::writeVertices(std::span<Vertex> vertices) const
+{
+    const std::vector<glm::vec2>& unitCircle = getUnitCircle(m_pointCount);
 
-    return v;
+    for(std::size_t i = 0; i < vertices.size(); ++i)
+    {
+        vertices[i] = Vertex{unitCircle[i] * m_radius};
+    }
+}
+
+void Circle::setTolerance(float pixels)
+{
+    m_tolerance = pixels;
+}
+
+float Circle::getTolerance() const
+{
+    return m_tolerance;
+}
+
+const std::vector<glm::vec2>& Circle::getUnitCircle(unsigned short pointCount)
+{
+    // References to the elements of an unordered_map stay valid when it grows
+    static std::unordered_map<unsigned short, std::vector<glm::vec2>> tables;
+
+    // The circles can be recorded in parallel, see Renderer::record()
+    static std::mutex mutex;
+    std::lock_guard lock(mutex);
+
+    std::vector<glm::vec2>& table = tables[pointCount];
+
+    if(table.empty())
+    {
+        table.resize(pointCount);
+
+        for(unsigned short i = 0; i < pointCount; ++i)
+        {
+            // angle is in [0;2pi[
+            const float angle = static_cast<float>(i) / static_cast<float>(pointCount) * TAU;
+            table[i] = {std::cos(angle), std::sin(angle)};
+        }
+    }
+
+    return table;
+}
+
+void Circle::setMode(Mode mode)
+{
+    m_mode = mode;
+}
+
+Circle::Mode Circle::getMode() const
+{
+    return m_mode;
+}
+
+std::span<const Vertex> Circle::getQuadVertices()
+{
+    static const Vertex quad[] {
+        Vertex{{-1.0f, -1.0f}},
+        Vertex{{1.0f, -1.0f}},
+        Vertex{{-1.0f, 1.0f}},
+        Vertex{{1.0f, 1.0f}}
+    };
+
+    return quad;
+}
+
+Rect Circle::getLocalBounds() const
+{
+    // The polygon is inscribed in the circle, but the miter joins of its outline are further than the thickness.
+    // There are no joins below 3 points, and the factor would be negative or huge.
+    const float miter = m_pointCount >= 3 ? 1.0f / std::cos(PI / static_cast<float>(m_pointCount)) : 1.0f;
+    const float radius = m_radius + std::max(getOutlineThickness(), 0.0f) * miter;
+    return Rect{glm::vec2{2.0f * radius}};
 }
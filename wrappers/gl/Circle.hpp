@@ -1,17 +1,82 @@
 #pragma once
 
 #include "Shape.hpp"
+#include <glm/vec2.hpp>
+#include <span>
+#include <vector>
 
+/// @brief A circle of radius 1, centered in (0, 0).
+/// @details
+/// By default, the count of points adapts to the size of the circle on the screen: it is the smallest power of two
+/// such that the distance between the polygon and the real circle is under the tolerance, in pixels.
+/// So a small circle has few vertices, and a zoomed-in circle stays smooth.
+/// The positions come from unit circle tables shared by all the circles with the same count of points,
+/// so changing the level of detail never computes a sine or a cosine.
+/// In SDF mode, the circle is not tessellated at all: it is drawn as a single quad, and the fragment shader computes
+/// the distance to the circle to find the fill, the outline and an anti-aliased border. The edge is exact at any zoom,
+/// and the count of vertices is always 4.
 class Circle : public Shape
 {
 public:
-    Circle(unsigned short pointCount = 30);
+    /// @brief Count of points to adapt to the screen size.
+    static constexpr unsigned short adaptive = 0;
+
+    enum class Mode
+    {
+        Tessellated, ///< Polygon drawn as a triangle fan, with the outline as a triangle strip.
+        SDF, ///< Quad, the circle and its outline are computed in the fragment shader.
+    };
+
+    /// @param pointCount The fixed count of points, or adaptive.
+    Circle(unsigned short pointCount = adaptive);
+
+    void draw(RenderStates states = {}) const override;
 
     size_t getVerticesCount() const override;
     Vertex getVertex(int index) const override;
+    void writeVertices(std::span<Vertex> vertices) const override;
+
+    /// @details Known without generating the vertices, so the SDF mode never tessellates the circle.
+    Rect getLocalBounds() const override;
+
+    /// @brief Set the maximum distance between the polygon and the real circle, in pixels.
+    /// @details Only used if the count of points is adaptive. 0.5 by default.
+    void setTolerance(float pixels);
+    float getTolerance() const;
+
+    /// @brief Get the positions of the points of a circle of radius 1.
+    /// @details The tables are computed once and shared by all the circles.
+    /// @remarks Thread-safe.
+    static const std::vector<glm::vec2>& getUnitCircle(unsigned short pointCount);
+
+    /// @brief Set how the circle is rendered. Tessellated by default.
+    /// @details In SDF mode, the circle is not batched with the Renderer, and the shader should support the u_SDF
+    /// uniform like assets/frag.glsl. The vertices returned by getVertices() are still the tessellated ones.
+    void setMode(Mode mode);
+    Mode getMode() const;
+
+    /// @brief Get the quad drawn in SDF mode.
+    /// @details The square [-1, 1]², drawn as a triangle strip. The shader scales it to also cover the outline.
+    static std::span<const Vertex> getQuadVertices();
 
 private:
+    void drawSDF(RenderStates states) const;
+
+    /// @brief Get the count of points for the circle drawn with a transformation.
+    /// @param viewport The size of the viewport in pixels, the current one if zero, see RenderStates::viewport.
+    unsigned short getAdaptivePointCount(const glm::mat4& transform, glm::ivec2 viewport) const;
+
+    static constexpr unsigned short minPointCount = 8;
+    static constexpr unsigned short maxPointCount = 1024;
+
+    /// @brief Count of points before the first draw, when the size on the screen is not known.
+    static constexpr unsigned short defaultPointCount = 32;
+
     float m_radius;
-    unsigned short m_pointCount;
-};
+    bool m_adaptive;
+    float m_tolerance{0.5f};
+    Mode m_mode{Mode::Tessellated};
 
+    /// @remarks mutable because adaptive circles choose it when drawn.
+    mutable unsigned short m_pointCount;
+};
@@ -1,5 +1,7 @@
-
 #include "ConvexShape.hpp"
+#include "Triangulation.hpp"
+#include <algorithm>
+
 
 size_t ConvexShape::getVerticesCount() const
 {
@@ -11,14 +13,52 @@ Vertex ConvexShape::getVertex(int index) const
     return m_vertices[index];
 }
 
+void ConvexShape::writeVertices(std::span<Vertex> vertices) const
+{
+    std::copy(m_vertices.begin(), m_vertices.end(), vertices.begin());
+}
+
+std::span<const std::uint32_t> ConvexShape::getTriangles() const
+{
+    if(m_needTriangulation)
+    {
+        m_needTriangulation = false;
+
+        if(Triangulation::isConvex(m_vertices))
+        {
+            m_triangles.clear();
+        }
+        else
+        {
+            Triangulation::triangulate(m_vertices, m_triangles);
+        }
+    }
+
+    return m_triangles;
+}
+
 void ConvexShape::setVerticesCount(std::size_t count)
 {
-    m_vertices.resize(count);
+    if(m_vertices.size() != count)
+    {
+        m_vertices.resize(count);
+        m_needTriangulation = true;
+    }
+
     needUpdate();
 }
 
 void ConvexShape::setVertex(int index, const Vertex& vertex)
 {
-    m_vertices[index] = vertex;
-    needUpdate();
+    if(m_vertices[index] != vertex)
+    {
+        // Only the positions change the triangulation, not the colors or texture coordinates
+        if(m_vertices[index].pos != vertex.pos)
+        {
+            m_needTriangulation = true;
+        }
+
+        m_vertices[index] = vertex;
+        needUpdate(static_cast<std::size_t>(index));
+    }
 }
@@ -7,18 +7,24 @@
 /// vertices. But, in theory, Shape is also convex. This simple naming convention is better, has the user does not
 /// need to know the Shape is concave because he will use child classes. This is somehow a different convention
 /// from SFML: sf::ConvexShape == Shape, sf::VertexArray = ConvexShape.
-/// @remarks
-/// If the shape is not filled or rendered with GL_LINES or GL_POINTS, then the shape can be not convex.
+/// Despite the name, the polygon can also be concave, as long as it is simple (it does not intersect itself):
+/// it is then triangulated (see Triangulation). The triangulation is cached, and only computed again when a
+/// position is changed with setVertex() or the count of vertices changes.
+/// Convex polygons are still drawn as a fan, without indices.
 class ConvexShape : public Shape
 {
 public:
     std::size_t getVerticesCount() const override;
     Vertex getVertex(int index) const override;
+    void writeVertices(std::span<Vertex> vertices) const override;
+    std::span<const std::uint32_t> getTriangles() const override;
 
     void setVerticesCount(std::size_t count);
     void setVertex(int index, const Vertex& vertex);
 
 private:
     std::vector<Vertex> m_vertices;
-};
 
+    mutable std::vector<std::uint32_t> m_triangles; ///< Empty if convex.
+    mutable bool m_needTriangulation{true};
+};
@@ -0,0 +1,230 @@
+#include "DebugDraw.hpp"
+#include "Circle.hpp"
+#include "Line.hpp"
+#include "Renderer.hpp"
+#include "StreamBuffer.hpp"
+#include <wrappers/freetype/Text.hpp>
+#include <algorithm>
+
+DebugDraw& DebugDraw::getGlobal()
+{
+    static DebugDraw debugDraw;
+    return debugDraw;
+}
+
+void DebugDraw::line(const glm::vec2& a, const glm::vec2& b, const glm::vec4& color, float thickness)
+{
+    if(thickness > 0.0f)
+    {
+        const auto quad = Line::getQuad(a, b, thickness);
+        triangle(quad[0], quad[1], quad[2], color);
+        triangle(quad[2], quad[1], quad[3], color);
+    }
+    else
+    {
+        m_lines.emplace_back(a, color);
+        m_lines.emplace_back(b, color);
+    }
+}
+
+void DebugDraw::rect(const glm::vec2& min, const glm::vec2& max, const glm::vec4& color, float thickness)
+{
+    const glm::vec2 corners[] {min, {max.x, min.y}, max, {min.x, max.y}};
+
+    for(int i = 0; i < 4; ++i)
+    {
+        line(corners[i], corners[(i + 1) % 4], color, thickness);
+    }
+}
+
+void DebugDraw::fillRect(const glm::vec2& min, const glm::vec2& max, const glm::vec4& color)
+{
+    triangle(min, {max.x, min.y}, max, color);
+    triangle(min, max, {min.x, max.y}, color);
+}
+
+void DebugDraw::circle(const glm::vec2& center, float radius, const glm::vec4& color, float thickness,
+                       unsigned short pointCount)
+{
+    const std::vector<glm::vec2>& unitCircle = Circle::getUnitCircle(pointCount);
+
+    for(std::size_t i = 0; i < pointCount; ++i)
+    {
+        line(center + unitCircle[i] * radius, center + unitCircle[(i + 1) % pointCount] * radius, color, thickness);
+    }
+}
+
+void DebugDraw::fillCircle(const glm::vec2& center, float radius, const glm::vec4& color, unsigned short pointCount)
+{
+    const std::vector<glm::vec2>& unitCircle = Circle::getUnitCircle(pointCount);
+
+    for(std::size_t i = 0; i < pointCount; ++i)
+    {
+        triangle(center, center + unitCircle[i] * radius, center + unitCircle[(i + 1) % pointCount] * radius, color);
+    }
+}
+
+void DebugDraw::text(const glm::vec2& position, std::string_view string, const Font& font, const glm::vec4& color,
+                     float scale)
+{
+    glm::vec2 cursor{0.0f};
+
+    for(char c : string)
+    {
+        const Glyph& glyph = font.getGlyph(c);
+
+        if(glyph.size.x > 0.0f && glyph.size.y > 0.0f)
+        {
+            auto page = std::find_if(m_pages.begin(), m_pages.end(), [&](const Page& p) {
+                return p.texture == glyph.texture;
+            });
+
+            if(page == m_pages.end())
+            {
+                page = m_pages.insert(m_pages.end(), Page{glyph.texture, {}});
+            }
+
+            const std::size_t first = page->vertices.size();
+            Text::appendQuad(page->vertices, cursor, glyph, color);
+
+            // The glyphs are in pixels
+            for(std::size_t i = first; i < page->vertices.size(); ++i)
+            {
+                page->vertices[i].pos = position + page->vertices[i].pos * scale;
+            }
+        }
+
+        cursor.x += glyph.advance;
+    }
+}
+
+void DebugDraw::triangle(const glm::vec2& a, const glm::vec2& b, const glm::vec2& c, const glm::vec4& color)
+{
+    m_triangles.insert(m_triangles.end(), {Vertex{a, color}, Vertex{b, color}, Vertex{c, color}});
+}
+
+void DebugDraw::flush(RenderStates states)
+{
+    if(!states.shader || getVertexCount() == 0)
+    {
+        clear();
+        return;
+    }
+
+    if(states.renderer)
+    {
+        states.renderer->flush();
+    }
+
+    StreamBuffer& stream = StreamBuffer::getGlobal();
+    stream.bindVertexArray(Vertex::Format::Full);
+
+    Shader::bind(states.shader);
+
+    states.shader->setUniform("u_ModelMatrix", states.model);
+    states.shader->setUniform("u_ViewMatrix", states.view);
+    states.shader->setUniform("u_Color", glm::vec4{1.0f}); // The colors are in the vertices
+
+    // A multiple of the vertices of a line and of a triangle, so the chunks only split between primitives
+    const std::size_t maxCount = stream.getMaxVertexCount(Vertex::Format::Full) / 6 * 6;
+    bool text = false;
+
+    // Write the concatenated ranges at once, and draw each of them
+    auto submit = [&]() {
+        if(m_upload.empty())
+        {
+            return;
+        }
+
+        GLint first = stream.write(m_upload, Vertex::Format::Full);
+
+        for(const Range& range : m_ranges)
+        {
+            Texture::bind(range.texture);
+
+            if(text != (range.texture != nullptr))
+            {
+                text = !text;
+                states.shader->setUniform("u_Text", text);
+            }
+
+            glDrawArrays(range.primitive, first, static_cast<GLsizei>(range.count));
+            first += static_cast<GLint>(range.count);
+        }
+
+        m_upload.clear();
+        m_ranges.clear();
+    };
+
+    // Concatenate the vertices, submitting them when a chunk is full
+    auto append = [&](GLenum primitive, const Texture *texture, std::span<const Vertex> vertices) {
+        while(!vertices.empty())
+        {
+            if(m_upload.size() == maxCount)
+            {
+                submit();
+            }
+
+            std::size_t count = std::min(vertices.size(), maxCount - m_upload.size());
+
+            if(count < vertices.size())
+            {
+                count -= count % (primitive == GL_LINES ? 2 : 3);
+
+                if(count == 0)
+                {
+                    submit();
+                    continue;
+                }
+            }
+
+            m_upload.insert(m_upload.end(), vertices.begin(), vertices.begin() + static_cast<std::ptrdiff_t>(count));
+            m_ranges.push_back({primitive, texture, count});
+            vertices = vertices.subspan(count);
+        }
+    };
+
+    m_upload.clear();
+    m_ranges.clear();
+
+    append(GL_LINES, nullptr, m_lines);
+    append(GL_TRIANGLES, nullptr, m_triangles);
+
+    for(const Page& page : m_pages)
+    {
+        append(GL_TRIANGLES, page.texture, page.vertices);
+    }
+
+    submit();
+
+    // Not used anywhere else so we should release the flag ourselves
+    if(text)
+    {
+        states.shader->setUniform("u_Text", false);
+    }
+
+    clear();
+}
+
+void DebugDraw::clear()
+{
+    m_lines.clear();
+    m_triangles.clear();
+
+    for(Page& page : m_pages)
+    {
+        page.vertices.clear();
+    }
+}
+
+std::size_t DebugDraw::getVertexCount() const
+{
+    std::size_t count = m_lines.size() + m_triangles.size();
+
+    for(const Page& page : m_pages)
+    {
+        count += page.vertices.size();
+    }
+
+    return count;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "RenderStates.hpp"
+#include "Texture.hpp"
+#include "Vertex.hpp"
+#include <wrappers/freetype/Font.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+#include <span>
+#include <string_view>
+#include <vector>
+
+/// @brief Immediate mode drawing of transient shapes, for debugging.
+/// @details
+/// The shapes are appended to CPU arrays during the frame, without any GL object per shape. flush() writes all the
+/// vertices in the global StreamBuffer at once, and draws them with one draw call for the lines of one pixel, one for
+/// the triangles, and one per atlas page for the text. Then the arrays are cleared, but their memory is kept for the
+/// next frame.
+/// A single write is limited to a region of the StreamBuffer (see StreamBuffer::getMaxVertexCount()), about 131k
+/// vertices by default. Above, the vertices are written and drawn in several chunks of at most this size.
+/// The coordinates are in the space of the model matrix of the RenderStates given to flush(), usually the world space.
+/// A thickness of zero draws lines of one pixel, otherwise the thickness is in the same units as the coordinates.
+class DebugDraw
+{
+public:
+    /// @brief Get the instance shared by the whole program, so that anything can be drawn from anywhere.
+    static DebugDraw& getGlobal();
+
+    void line(const glm::vec2& a, const glm::vec2& b, const glm::vec4& color = glm::vec4{1.0f}, float thickness = 0.0f);
+
+    /// @brief Outline of an axis-aligned rectangle.
+    void rect(const glm::vec2& min, const glm::vec2& max, const glm::vec4& color = glm::vec4{1.0f},
+              float thickness = 0.0f);
+
+    void fillRect(const glm::vec2& min, const glm::vec2& max, const glm::vec4& color = glm::vec4{1.0f});
+
+    /// @brief Outline of a circle.
+    void circle(const glm::vec2& center, float radius, const glm::vec4& color = glm::vec4{1.0f},
+                float thickness = 0.0f, unsigned short pointCount = 32);
+
+    void fillCircle(const glm::vec2& center, float radius, const glm::vec4& color = glm::vec4{1.0f},
+                    unsigned short pointCount = 32);
+
+    /// @brief Single line of text.
+    /// @param position The start of the baseline.
+    /// @param scale The size of a pixel of the font, in the units of the coordinates.
+    void text(const glm::vec2& position, std::string_view string, const Font& font,
+              const glm::vec4& color = glm::vec4{1.0f}, float scale = 1.0f);
+
+    /// @brief Draw everything appended since the last flush, then clear it.
+    /// @details If there is a Renderer in the states, it is flushed first to keep the order of the draw calls.
+    void flush(RenderStates states);
+
+    /// @brief Discard everything appended since the last flush.
+    void clear();
+
+    /// @returns The count of vertices appended since the last flush.
+    std::size_t getVertexCount() const;
+
+private:
+    /// @brief Text vertices using the same atlas page.
+    struct Page
+    {
+        const Texture *texture;
+        std::vector<Vertex> vertices;
+    };
+
+    /// @brief Vertices of the upload drawn with one draw call.
+    struct Range
+    {
+        GLenum primitive;
+        const Texture *texture; ///< nullptr for the shapes, the atlas page for the text.
+        std::size_t count;
+    };
+
+    void triangle(const glm::vec2& a, const glm::vec2& b, const glm::vec2& c, const glm::vec4& color);
+
+    // The arena: cleared at each flush, but the memory is reused
+    std::vector<Vertex> m_lines; ///< GL_LINES
+    std::vector<Vertex> m_triangles; ///< GL_TRIANGLES
+    std::vector<Page> m_pages; ///< GL_TRIANGLES, pages without vertices are kept for the next frames
+
+    std::vector<Vertex> m_upload; ///< The vertices concatenated, for a single streaming write per chunk.
+    std::vector<Range> m_ranges; ///< The draw calls of the chunk in m_upload.
+};
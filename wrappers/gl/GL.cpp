@@ -2,6 +2,87 @@
 #include <utility/Exception.hpp>
 #include <cstdio>
 #include <cassert>
+#include <algorithm>
+#include <iterator>
+
+namespace GL
+{
+    namespace
+    {
+        /// @brief Value of a cached state that is not known.
+        constexpr GLuint unknown = ~0u;
+
+        constexpr int maxTextureUnits = 16;
+
+        /// @brief Shadow of the OpenGL state.
+        struct State
+        {
+            GLuint program{unknown};
+            GLenum activeUnit{unknown};
+            GLuint textures[maxTextureUnits];
+            GLuint vao{unknown};
+            GLuint arrayBuffer{unknown};
+
+            GLuint blending{unknown}; // GL_TRUE, GL_FALSE or unknown
+            GLenum blendSrc{unknown};
+            GLenum blendDst{unknown};
+
+            GLint unpackAlignment{-1};
+            GLint unpackRowLength{-1};
+            GLint unpackSkipPixels{-1};
+            GLint unpackSkipRows{-1};
+            GLint packAlignment{-1};
+
+            Viewport viewport;
+
+            State()
+            {
+                std::fill(std::begin(textures), std::end(textures), unknown);
+            }
+        };
+
+        State state;
+        Counters counters;
+
+        /// @brief Update the cached value.
+        /// @returns true if the call should be forwarded to OpenGL.
+        template<typename T>
+        bool change(T& cached, T value)
+        {
+            if(cached == value)
+            {
+                counters.skipped++;
+                return false;
+            }
+
+            cached = value;
+            counters.issued++;
+            return true;
+        }
+
+        /// @brief Forget a binding when the object is deleted. OpenGL resets the binding to zero in this case.
+        void forget(GLuint& cached, GLuint id)
+        {
+            if(cached == id)
+            {
+                cached = 0;
+            }
+        }
+
+        GLint* getPixelStore(GLenum pname)
+        {
+            switch(pname)
+            {
+                case GL_UNPACK_ALIGNMENT: return &state.unpackAlignment;
+                case GL_UNPACK_ROW_LENGTH: return &state.unpackRowLength;
+                case GL_UNPACK_SKIP_PIXELS: return &state.unpackSkipPixels;
+                case GL_UNPACK_SKIP_ROWS: return &state.unpackSkipRows;
+                case GL_PACK_ALIGNMENT: return &state.packAlignment;
+                default: return nullptr;
+            }
+        }
+    }
+}
 
 GL::Shader::Shader(GLenum type)
 {
@@ -31,6 +112,12 @@ GL::Program::Program()
 
 GL::Program::~Program()
 {
+    // A program in use is only flagged for deletion, but it is safer to bind it again next time
+    if(state.program == id)
+    {
+        state.program = unknown;
+    }
+
     glDeleteProgram(id);
     id = 0;
 }
@@ -42,6 +129,7 @@ GL::Buffer::Buffer()
 
 GL::Buffer::~Buffer()
 {
+    forget(state.arrayBuffer, id);
     glDeleteBuffers(1, &id);
 }
 
@@ -52,6 +140,7 @@ GL::VertexArray::VertexArray()
 
 GL::VertexArray::~VertexArray()
 {
+    forget(state.vao, id);
     glDeleteVertexArrays(1, &id);
 }
 
@@ -62,6 +151,11 @@ GL::Texture::Texture()
 
 GL::Texture::~Texture()
 {
+    for(GLuint& texture : state.textures)
+    {
+        forget(texture, id);
+    }
+
     glDeleteTextures(1, &id);
 }
 
@@ -104,3 +198,163 @@ void GL::enableDebugging(bool throwOnError)
     glEnable(GL_DEBUG_OUTPUT);
     glDebugMessageCallback(GL::onError, 0);
 }
+
+void GL::useProgram(GLuint program)
+{
+    if(change(state.program, program))
+    {
+        glUseProgram(program);
+    }
+}
+
+void GL::activeTexture(GLenum unit)
+{
+    assert(unit >= GL_TEXTURE0 && unit < GL_TEXTURE0 + maxTextureUnits);
+
+    if(change(state.activeUnit, unit))
+    {
+        glActiveTexture(unit);
+    }
+}
+
+void GL::bindTexture(GLenum target, GLuint texture)
+{
+    if(target != GL_TEXTURE_2D || state.activeUnit == unknown)
+    {
+        counters.issued++;
+        glBindTexture(target, texture);
+
+        if(target == GL_TEXTURE_2D)
+        {
+            // The active unit is unknown, so no binding of any unit can be trusted
+            std::fill(std::begin(state.textures), std::end(state.textures), unknown);
+        }
+    }
+    else if(change(state.textures[state.activeUnit - GL_TEXTURE0], texture))
+    {
+        glBindTexture(target, texture);
+    }
+}
+
+void GL::bindVertexArray(GLuint vao)
+{
+    if(change(state.vao, vao))
+    {
+        glBindVertexArray(vao);
+    }
+}
+
+void GL::bindBuffer(GLenum target, GLuint buffer)
+{
+    if(target != GL_ARRAY_BUFFER)
+    {
+        counters.issued++;
+        glBindBuffer(target, buffer);
+    }
+    else if(change(state.arrayBuffer, buffer))
+    {
+        glBindBuffer(target, buffer);
+    }
+}
+
+void GL::setBlending(bool enabled)
+{
+    if(change(state.blending, static_cast<GLuint>(enabled ? GL_TRUE : GL_FALSE)))
+    {
+        if(enabled)
+        {
+            glEnable(GL_BLEND);
+        }
+        else
+        {
+            glDisable(GL_BLEND);
+        }
+    }
+}
+
+void GL::blendFunc(GLenum sfactor, GLenum dfactor)
+{
+    if(state.blendSrc == sfactor && state.blendDst == dfactor)
+    {
+        counters.skipped++;
+    }
+    else
+    {
+        state.blendSrc = sfactor;
+        state.blendDst = dfactor;
+        counters.issued++;
+        glBlendFunc(sfactor, dfactor);
+    }
+}
+
+void GL::pixelStore(GLenum pname, GLint param)
+{
+    GLint *cached = getPixelStore(pname);
+
+    if(!cached)
+    {
+        counters.issued++;
+        glPixelStorei(pname, param);
+    }
+    else if(change(*cached, param))
+    {
+        glPixelStorei(pname, param);
+    }
+}
+
+void GL::viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    if(change(state.viewport, Viewport{x, y, width, height}))
+    {
+        glViewport(x, y, width, height);
+    }
+}
+
+const GL::Viewport& GL::getViewport()
+{
+    if(state.viewport.width < 0)
+    {
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+
+        state.viewport = {viewport[0], viewport[1], viewport[2], viewport[3]};
+    }
+
+    return state.viewport;
+}
+
+void GL::bufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage)
+{
+    glBufferData(target, size, data, usage);
+
+    if(data)
+    {
+        countUpload(static_cast<std::size_t>(size));
+    }
+}
+
+void GL::bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data)
+{
+    glBufferSubData(target, offset, size, data);
+    countUpload(static_cast<std::size_t>(size));
+}
+
+void GL::countUpload(std::size_t bytes)
+{
+    counters.uploadedBytes += bytes;
+}
+
+void GL::invalidateState()
+{
+    state = State{};
+}
+
+const GL::Counters& GL::getCounters()
+{
+    return counters;
+}
+
+void GL::resetCounters()
+{
+    counters = {};
+}
@@ -77,26 +77,101 @@ namespace GL
         ~VertexArray() override;
     };
 
+    /// @brief Rectangle of the viewport, in pixels.
+    struct Viewport
+    {
+        GLint x{0};
+        GLint y{0};
+        GLsizei width{-1}; ///< Negative if unknown.
+        GLsizei height{-1};
+
+        bool operator==(const Viewport& rhs) const = default;
+    };
+
+    /// @brief Counters of the state changing calls, to measure the efficiency of the state cache.
+    struct Counters
+    {
+        int issued{0}; ///< Calls forwarded to OpenGL.
+        int skipped{0}; ///< Redundant calls that were dropped.
+        std::size_t uploadedBytes{0}; ///< Bytes uploaded to buffers.
+    };
+
+    /// @name
+    /// @brief State cache.
+    /// @details
+    /// These functions shadow the current OpenGL state and drop the calls that would not change it.
+    /// All binds should go through them, otherwise the cache will be out of date. If some code binds objects
+    /// directly (like ImGui backend), invalidateState() should be called after.
+    /// Deleting an OpenGL object through the RAII wrappers also updates the cache.
+    /// @{
+
+    void useProgram(GLuint program);
+
+    /// @param unit The texture unit, GL_TEXTURE0 + i.
+    void activeTexture(GLenum unit);
+
+    /// @brief Bind a texture to the active texture unit.
+    /// @remarks Only GL_TEXTURE_2D is cached, other targets are always forwarded.
+    void bindTexture(GLenum target, GLuint texture);
+
+    void bindVertexArray(GLuint vao);
+
+    /// @remarks Only GL_ARRAY_BUFFER is cached, GL_ELEMENT_ARRAY_BUFFER is part of the VAO state.
+    void bindBuffer(GLenum target, GLuint buffer);
+
+    /// @brief Enable or disable GL_BLEND.
+    void setBlending(bool enabled);
+    void blendFunc(GLenum sfactor, GLenum dfactor);
+
+    /// @remarks Only the alignment, row length and skip parameters are cached.
+    void pixelStore(GLenum pname, GLint param);
+
+    void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+    /// @brief Get the current viewport, queried from OpenGL if it is not known.
+    const Viewport& getViewport();
+
+    /// @brief Forget all the cached state, the next calls will all be forwarded.
+    void invalidateState();
+
+    const Counters& getCounters();
+
+    /// @brief Reset the counters. Should be called once per frame.
+    void resetCounters();
+
+    /// @}
+
     /// @brief Catch all errors and print them to stderr when there is one.
     /// @see https://www.khronos.org/opengl/wiki/OpenGL_Error
     void enableDebugging(bool throwOnError = true);
 
+    /// @brief glBufferData(), counting the uploaded bytes.
+    void bufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage);
+
+    /// @brief glBufferSubData(), counting the uploaded bytes.
+    void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data);
+
+    /// @brief Count bytes uploaded without bufferData(), for example written to a mapped buffer.
+    void countUpload(std::size_t bytes);
+
     template<typename T>
     void bufferData(GLenum target, const std::vector<T>& buffer, GLenum usage)
     {
-        glBufferData(target, buffer.size() * sizeof(buffer[0]), buffer.data(), usage);
+        bufferData(target, static_cast<GLsizeiptr>(buffer.size() * sizeof(T)), buffer.data(), usage);
     }
 
     /// @brief Enable and setup with glVertexAttribPointer()
     /// @details It can be tricky in C++ to use stride, because members are not necessarily packed.
+    /// @param normalized If integer values are mapped to [0, 1] (or [-1, 1] for signed types).
     template<typename Class, typename FieldType>
-    void vertexAttribPointer(GLuint index, GLint size, GLenum type, FieldType(Class::*field))
+    void vertexAttribPointer(GLuint index, GLint size, GLenum type, FieldType(Class::*field),
+                             GLboolean normalized = GL_FALSE)
     {
         // Compute the offset of the member
         // offset is C and doesn't works with templates
         // Taking the address will not dereference, not causing segfault.
 
-        glVertexAttribPointer(index, size, type, GL_FALSE, sizeof(Class), reinterpret_cast<const void*>(offset_of(field)));
+        glVertexAttribPointer(index, size, type, normalized, sizeof(Class), reinterpret_cast<const void*>(offset_of(field)));
         glEnableVertexAttribArray(index);
     }
 };
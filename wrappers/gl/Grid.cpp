@@ -0,0 +1,117 @@
+#include "Grid.hpp"
+#include "Renderer.hpp"
+#include "VertexBuffer.hpp"
+
+void Grid::draw(RenderStates states) const
+{
+    if(!states.shader)
+    {
+        return;
+    }
+
+    // Not batched, the uniforms are specific to the grid
+    if(states.renderer)
+    {
+        states.renderer->flush();
+    }
+
+    // Shared by all the grids, the whole clip space
+    static VertexBuffer quad;
+
+    if(quad.getCount() == 0)
+    {
+        const Vertex vertices[] {
+            Vertex{{-1.0f, -1.0f}},
+            Vertex{{1.0f, -1.0f}},
+            Vertex{{-1.0f, 1.0f}},
+            Vertex{{1.0f, 1.0f}}
+        };
+
+        quad.update(vertices);
+    }
+
+    Shader::bind(states.shader);
+    Texture::bind(nullptr);
+
+    states.shader->setUniform("u_ModelMatrix", states.model);
+    states.shader->setUniform("u_ViewMatrix", states.view);
+    states.shader->setUniform("u_GridSpacing", m_spacing);
+    states.shader->setUniform("u_GridSubdivision", m_subdivision);
+    states.shader->setUniform("u_GridMinPixels", m_minSpacing);
+    states.shader->setUniform("u_GridThickness", m_thickness);
+    states.shader->setUniform("u_GridColor", m_color);
+    states.shader->setUniform("u_GridAxisXColor", m_xAxisColor);
+    states.shader->setUniform("u_GridAxisYColor", m_yAxisColor);
+    states.shader->setUniform("u_Grid", true);
+
+    quad.draw(GL_TRIANGLE_STRIP);
+
+    // Not used anywhere else so we should release the flag ourselves
+    states.shader->setUniform("u_Grid", false);
+}
+
+void Grid::setSpacing(float spacing)
+{
+    m_spacing = spacing;
+}
+
+float Grid::getSpacing() const
+{
+    return m_spacing;
+}
+
+void Grid::setSubdivision(float subdivision)
+{
+    m_subdivision = subdivision;
+}
+
+float Grid::getSubdivision() const
+{
+    return m_subdivision;
+}
+
+void Grid::setMinSpacing(float pixels)
+{
+    m_minSpacing = pixels;
+}
+
+float Grid::getMinSpacing() const
+{
+    return m_minSpacing;
+}
+
+void Grid::setThickness(float pixels)
+{
+    m_thickness = pixels;
+}
+
+float Grid::getThickness() const
+{
+    return m_thickness;
+}
+
+void Grid::setColor(const glm::vec4& color)
+{
+    m_color = color;
+}
+
+const glm::vec4& Grid::getColor() const
+{
+    return m_color;
+}
+
+void Grid::setAxisColors(const glm::vec4& xAxis, const glm::vec4& yAxis)
+{
+    m_xAxisColor = xAxis;
+    m_yAxisColor = yAxis;
+}
+
+const glm::vec4& Grid::getXAxisColor() const
+{
+    return m_xAxisColor;
+}
+
+const glm::vec4& Grid::getYAxisColor() const
+{
+    return m_yAxisColor;
+}
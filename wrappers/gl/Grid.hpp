@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Drawable.hpp"
+#include <glm/vec4.hpp>
+
+/// @brief Infinite grid with its axes, computed in the fragment shader.
+/// @details
+/// A single quad covering the screen is drawn, and the fragment shader finds the lines under each pixel,
+/// so the cost is always one draw call of 4 vertices, whatever the zoom.
+/// When zooming out, the lines that would be too close to each other fade out, and only one line out of
+/// getSubdivision() is kept. When zooming in, the lines are subdivided in the same way.
+/// The grid is in the space of the model matrix of the RenderStates, usually the world space.
+/// It is not batched with the Renderer, but if there is one in the RenderStates it is flushed before drawing
+/// to keep the order of the draw calls.
+/// @remarks The shader should support the u_Grid uniform like assets/frag.glsl.
+class Grid : public Drawable
+{
+public:
+    void draw(RenderStates states = {}) const override;
+
+    /// @brief Distance between two lines at the default zoom level. 1 by default.
+    void setSpacing(float spacing);
+    float getSpacing() const;
+
+    /// @brief Count of lines between two lines of the next zoom level. 10 by default.
+    void setSubdivision(float subdivision);
+    float getSubdivision() const;
+
+    /// @brief Minimum distance between two lines, in pixels, before they fade out. 8 by default.
+    void setMinSpacing(float pixels);
+    float getMinSpacing() const;
+
+    /// @brief Width of the lines, in pixels. 1 by default.
+    void setThickness(float pixels);
+    float getThickness() const;
+
+    /// @brief Color of the lines. Half transparent white by default.
+    void setColor(const glm::vec4& color);
+    const glm::vec4& getColor() const;
+
+    /// @brief Color of the axes, the line y = 0 and the line x = 0. Red by default.
+    /// @details The transparent color hides an axis.
+    void setAxisColors(const glm::vec4& xAxis, const glm::vec4& yAxis);
+    const glm::vec4& getXAxisColor() const;
+    const glm::vec4& getYAxisColor() const;
+
+private:
+    float m_spacing{1.0f};
+    float m_subdivision{10.0f};
+    float m_minSpacing{8.0f};
+    float m_thickness{1.0f};
+
+    glm::vec4 m_color{1.0f, 1.0f, 1.0f, 0.5f};
+    glm::vec4 m_xAxisColor{1.0f, 0.0f, 0.0f, 1.0f};
+    glm::vec4 m_yAxisColor{1.0f, 0.0f, 0.0f, 1.0f};
+};
@@ -0,0 +1,122 @@
+#include "Indices.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+    /// @brief Append the indices of a list primitive, element(i) being the index of the i-th vertex.
+    template<typename Element>
+    void appendList(GLenum primitive, std::size_t count, const Element& element, std::vector<std::uint32_t>& indices)
+    {
+        switch(primitive)
+        {
+            case GL_TRIANGLE_FAN:
+                for(std::size_t i = 1; i + 1 < count; ++i)
+                {
+                    indices.push_back(element(0));
+                    indices.push_back(element(i));
+                    indices.push_back(element(i + 1));
+                }
+                break;
+
+            case GL_TRIANGLE_STRIP:
+                for(std::size_t i = 0; i + 2 < count; ++i)
+                {
+                    // Every odd triangle has an inverted winding in a strip
+                    const std::size_t odd = i % 2;
+                    indices.push_back(element(i + odd));
+                    indices.push_back(element(i + 1 - odd));
+                    indices.push_back(element(i + 2));
+                }
+                break;
+
+            case GL_LINE_STRIP:
+            case GL_LINE_LOOP:
+                for(std::size_t i = 0; i + 1 < count; ++i)
+                {
+                    indices.push_back(element(i));
+                    indices.push_back(element(i + 1));
+                }
+
+                if(primitive == GL_LINE_LOOP && count > 2)
+                {
+                    indices.push_back(element(count - 1));
+                    indices.push_back(element(0));
+                }
+                break;
+
+            default:
+                for(std::size_t i = 0; i < count; ++i)
+                {
+                    indices.push_back(element(i));
+                }
+                break;
+        }
+    }
+}
+
+GLenum Indices::getListPrimitive(GLenum primitive)
+{
+    switch(primitive)
+    {
+        case GL_POINTS:
+            return GL_POINTS;
+
+        case GL_LINES:
+        case GL_LINE_STRIP:
+        case GL_LINE_LOOP:
+            return GL_LINES;
+
+        default:
+            return GL_TRIANGLES;
+    }
+}
+
+void Indices::append(GLenum primitive, std::size_t count, std::uint32_t baseVertex, std::vector<std::uint32_t>& indices)
+{
+    appendList(primitive, count, [baseVertex](std::size_t i) {
+        return baseVertex + static_cast<std::uint32_t>(i);
+    }, indices);
+}
+
+void Indices::append(GLenum primitive, std::span<const std::uint32_t> elements, std::uint32_t baseVertex,
+                     std::vector<std::uint32_t>& indices)
+{
+    appendList(primitive, elements.size(), [elements, baseVertex](std::size_t i) {
+        return baseVertex + elements[i];
+    }, indices);
+}
+
+GLenum Indices::getType(std::size_t vertexCount)
+{
+    return vertexCount <= std::size_t{std::numeric_limits<std::uint16_t>::max()} + 1 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+
+std::size_t Indices::getSize(GLenum type)
+{
+    return type == GL_UNSIGNED_SHORT ? sizeof(std::uint16_t) : sizeof(std::uint32_t);
+}
+
+void Indices::pack(std::span<const std::uint32_t> indices, GLenum type, void *destination)
+{
+    if(type == GL_UNSIGNED_SHORT)
+    {
+        auto *shorts = static_cast<std::uint16_t*>(destination);
+
+        for(std::uint32_t index : indices)
+        {
+            *shorts++ = static_cast<std::uint16_t>(index);
+        }
+    }
+    else
+    {
+        std::memcpy(destination, indices.data(), indices.size_bytes());
+    }
+}
+
+void Indices::pack(std::span<const std::uint32_t> indices, GLenum type, std::vector<unsigned char>& buffer)
+{
+    buffer.resize(indices.size() * getSize(type));
+    pack(indices, type, buffer.data());
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "GL.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// @brief Conversion of primitives to indexed lists, for the element buffers.
+/// @details
+/// Strips, fans and loops cannot be concatenated in a single draw call, since consecutive geometries would connect
+/// to each other. As indexed lists (GL_TRIANGLES, GL_LINES or GL_POINTS), each vertex is still stored only once,
+/// and any count of geometries of the same list primitive can be drawn at once.
+/// The indices are always built as 32-bit, and converted to 16-bit when uploaded if all the vertices can be
+/// addressed with 16 bits.
+namespace Indices
+{
+    /// @brief Get the list primitive a primitive is converted to (GL_TRIANGLES, GL_LINES or GL_POINTS).
+    GLenum getListPrimitive(GLenum primitive);
+
+    /// @brief Append the indices drawing vertices as a list primitive.
+    /// @param primitive The primitive of the vertices.
+    /// @param count The count of vertices.
+    /// @param baseVertex The index of the first vertex.
+    void append(GLenum primitive, std::size_t count, std::uint32_t baseVertex, std::vector<std::uint32_t>& indices);
+
+    /// @brief Same as append(), for indexed vertices.
+    /// @param elements The indices of the vertices, drawn with the primitive.
+    void append(GLenum primitive, std::span<const std::uint32_t> elements, std::uint32_t baseVertex,
+                std::vector<std::uint32_t>& indices);
+
+    /// @returns GL_UNSIGNED_SHORT if vertexCount vertices can be addressed with 16-bit indices,
+    /// GL_UNSIGNED_INT otherwise.
+    GLenum getType(std::size_t vertexCount);
+
+    /// @returns The size of an index of a type, in bytes.
+    std::size_t getSize(GLenum type);
+
+    /// @brief Convert the indices to a type.
+    /// @param destination Where to write the indices, at least indices.size() * getSize(type) bytes.
+    void pack(std::span<const std::uint32_t> indices, GLenum type, void *destination);
+
+    /// @brief Convert the indices to a type.
+    /// @param buffer Replaced by the indices in the type, ready to be uploaded.
+    void pack(std::span<const std::uint32_t> indices, GLenum type, std::vector<unsigned char>& buffer);
+}
@@ -1,4 +1,3 @@
-
 #include "Line.hpp"
 
 Line::Line()
@@ -6,17 +5,39 @@ Line::Line()
 {
 }
 
+std::array<glm::vec2, 4> Line::getQuad(const glm::vec2& a, const glm::vec2& b, float thickness)
+{
+    const glm::vec2 ab = b - a;
+    const float length = glm::length(ab);
+
+    // Half of the thickness on each side
+    const glm::vec2 normal = length > 0.0f ? glm::vec2{-ab.y, ab.x} * (thickness / (2.0f * length)) : glm::vec2{0.0f};
+
+    return {a - normal, a + normal, b - normal, b + normal};
+}
+
 std::vector<Vertex> Line::loadVertices() const
 {
     std::vector<Vertex> vertices;
     Vertex v;
     v.color = m_color;
 
-    v.pos = m_a;
-    vertices.push_back(v);
-
-    v.pos = m_b;
-    vertices.push_back(v);
+    if(m_thickness > 0.0f)
+    {
+        for(const glm::vec2& corner : getQuad(m_a, m_b, m_thickness))
+        {
+            v.pos = corner;
+            vertices.push_back(v);
+        }
+    }
+    else
+    {
+        v.pos = m_a;
+        vertices.push_back(v);
+
+        v.pos = m_b;
+        vertices.push_back(v);
+    }
 
     return vertices;
 }
@@ -29,5 +50,5 @@ void Line::update(const glm::vec2& a, const glm::vec2& b, const glm::vec4& color
     m_thickness = thickness;
 
     setVertices(loadVertices());
-    setPrimitiveType(GL_LINE_STRIP);
+    setPrimitiveType(m_thickness > 0.0f ? GL_TRIANGLE_STRIP : GL_LINE_STRIP);
 }
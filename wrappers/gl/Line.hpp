@@ -1,13 +1,18 @@
 #pragma once
 
 #include "VertexArray.hpp"
+#include <array>
 
 class Line : public VertexArray
 {
 public:
     Line();
 
-    void update(const glm::vec2& a, const glm::vec2& b, const glm::vec4& color = glm::vec4(1.0f), float thickness = 1.0f);
+    /// @param thickness The width of the line, in the units of the model. Zero for a line of one pixel.
+    void update(const glm::vec2& a, const glm::vec2& b, const glm::vec4& color = glm::vec4(1.0f), float thickness = 0.0f);
+
+    /// @brief Get the rectangle covering a thick line, as a triangle strip.
+    static std::array<glm::vec2, 4> getQuad(const glm::vec2& a, const glm::vec2& b, float thickness);
 
 protected:
     std::vector<Vertex> loadVertices() const;
@@ -18,4 +23,3 @@ private:
     glm::vec2 m_b;
     glm::vec4 m_color;
 };
-
@@ -0,0 +1,139 @@
+#include "Outline.hpp"
+#include <utility/ThreadPool.hpp>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define OUTLINE_SSE2
+    #include <emmintrin.h>
+#endif
+
+namespace
+{
+    /// @brief Avoid the division by zero when an edge goes back on the previous one.
+    constexpr float minDenominator = 1e-6f;
+
+    /// @brief Count of vertices computed at once by the SIMD kernel.
+    constexpr std::size_t blockSize = 4;
+
+    glm::vec2 getOutlinePosition(const glm::vec2& a, const glm::vec2& b, const glm::vec2& c, float thickness)
+    {
+        const glm::vec2 ab = glm::normalize(b - a);
+        const glm::vec2 bc = glm::normalize(c - b);
+
+        const glm::vec2 nab{ab.y, -ab.x};
+        const glm::vec2 nbc{bc.y, -bc.x};
+
+        return b + (nab + nbc) * (thickness / std::max(1.0f + glm::dot(nab, nbc), minDenominator));
+    }
+
+    /// @brief Compute the outline of the vertices in [begin, end).
+    void computeRange(std::span<const Vertex> polygon, float thickness, std::span<glm::vec2> outer,
+                      std::size_t begin, std::size_t end)
+    {
+        const std::size_t size = polygon.size();
+
+        // Index in the polygon, i can be one before the first or after the last (no modulo, it is slow)
+        auto wrap = [size](std::size_t i) {
+            if(i == static_cast<std::size_t>(-1))
+            {
+                return size - 1;
+            }
+
+            return i >= size ? i - size : i;
+        };
+
+        std::size_t i = begin;
+
+#ifdef OUTLINE_SSE2
+        for(; i + blockSize <= end; i += blockSize)
+        {
+            // The vertices i - 1 to i + 4 are the a, b and c of the 4 vertices, shifted by one
+            float xs[blockSize + 2], ys[blockSize + 2];
+
+            for(std::size_t k = 0; k < blockSize + 2; ++k)
+            {
+                const glm::vec2& pos = polygon[wrap(i + k - 1)].pos;
+                xs[k] = pos.x;
+                ys[k] = pos.y;
+            }
+
+            const __m128 ax = _mm_loadu_ps(&xs[0]), ay = _mm_loadu_ps(&ys[0]);
+            const __m128 bx = _mm_loadu_ps(&xs[1]), by = _mm_loadu_ps(&ys[1]);
+            const __m128 cx = _mm_loadu_ps(&xs[2]), cy = _mm_loadu_ps(&ys[2]);
+
+            // Normalized edges
+            __m128 abx = _mm_sub_ps(bx, ax), aby = _mm_sub_ps(by, ay);
+            __m128 bcx = _mm_sub_ps(cx, bx), bcy = _mm_sub_ps(cy, by);
+
+            const __m128 abLength = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(abx, abx), _mm_mul_ps(aby, aby)));
+            const __m128 bcLength = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(bcx, bcx), _mm_mul_ps(bcy, bcy)));
+
+            abx = _mm_div_ps(abx, abLength);
+            aby = _mm_div_ps(aby, abLength);
+            bcx = _mm_div_ps(bcx, bcLength);
+            bcy = _mm_div_ps(bcy, bcLength);
+
+            // The normals are (y, -x), so dot(nab, nbc) = dot(ab, bc)
+            const __m128 dot = _mm_add_ps(_mm_mul_ps(abx, bcx), _mm_mul_ps(aby, bcy));
+            const __m128 denominator = _mm_max_ps(_mm_add_ps(_mm_set1_ps(1.0f), dot), _mm_set1_ps(minDenominator));
+            const __m128 k = _mm_div_ps(_mm_set1_ps(thickness), denominator);
+
+            const __m128 x = _mm_add_ps(bx, _mm_mul_ps(_mm_add_ps(aby, bcy), k));
+            const __m128 y = _mm_sub_ps(by, _mm_mul_ps(_mm_add_ps(abx, bcx), k));
+
+            // Interleave back to vec2
+            _mm_storeu_ps(&outer[i].x, _mm_unpacklo_ps(x, y));
+            _mm_storeu_ps(&outer[i + 2].x, _mm_unpackhi_ps(x, y));
+        }
+#endif
+
+        for(; i < end; ++i)
+        {
+            outer[i] = getOutlinePosition(polygon[wrap(i - 1)].pos, polygon[i].pos, polygon[wrap(i + 1)].pos, thickness);
+        }
+    }
+}
+
+void Outline::compute(std::span<const Vertex> polygon, float thickness, std::span<glm::vec2> outer, ThreadPool *pool)
+{
+    const std::size_t size = polygon.size();
+
+    if(pool && size >= minParallelCount)
+    {
+        pool->parallelFor(size, [&](std::size_t begin, std::size_t end) {
+            computeRange(polygon, thickness, outer, begin, end);
+        }, 1024);
+    }
+    else
+    {
+        computeRange(polygon, thickness, outer, 0, size);
+    }
+}
+
+void Outline::computeReference(std::span<const Vertex> polygon, float thickness, std::span<glm::vec2> outer)
+{
+    const std::size_t count = polygon.size();
+
+    for(std::size_t k = 0; k < count; ++k)
+    {
+        const std::size_t kk = k + count; // Ensure in range of vertices with modulo (taking the previous and next vertices)
+        const glm::vec2& a = polygon[(kk - 1) % count].pos;
+        const glm::vec2& b = polygon[kk % count].pos;
+        const glm::vec2& c = polygon[(kk + 1) % count].pos;
+
+        const glm::vec2 ab = glm::normalize(b - a);
+        const glm::vec2 bc = glm::normalize(c - b);
+
+        const glm::vec2 nab {ab.y, -ab.x};
+        const glm::vec2 nbc {bc.y, -bc.x};
+
+        const float x = std::acos(glm::dot(nab, nbc));
+
+        // Tan=Opp/adj
+        const float y = std::tan(x / 2.0f) * thickness;
+
+        outer[k] = b + nab * thickness + ab * y;
+    }
+}
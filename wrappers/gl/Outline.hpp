@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Vertex.hpp"
+#include <glm/vec2.hpp>
+#include <cstddef>
+#include <span>
+
+class ThreadPool;
+
+/// @brief Computation of the outer border of the outline of a polygon, used by Shape.
+/// @details
+/// The outer vertex of the outline at a vertex b is at the intersection of the two edges around b, moved by the
+/// thickness along their normals. It is b + (nab + nbc) * thickness / (1 + dot(nab, nbc)), where nab and nbc are the
+/// unit normals of the edges: the sum of the normals is along the bisector, of length 2cos(x/2), and
+/// 1 + dot(nab, nbc) is 2cos²(x/2), so the offset has the miter length thickness / cos(x/2).
+/// There is no trigonometric function. With SSE2, four vertices are computed at a time, and big polygons are split
+/// across the threads of a ThreadPool.
+namespace Outline
+{
+    /// @brief Under this count of vertices, the computation is not parallelized.
+    constexpr std::size_t minParallelCount = 1 << 15;
+
+    /// @brief Compute the outer border of the outline of a closed polygon.
+    /// @param outer The destination, of the same size as the polygon.
+    /// @param pool If not null and the polygon is big enough, the work is split across its threads.
+    void compute(std::span<const Vertex> polygon, float thickness, std::span<glm::vec2> outer,
+                 ThreadPool *pool = nullptr);
+
+    /// @brief Same as compute(), with the previous algorithm: acos() and tan() per vertex, on a single thread.
+    /// @details Only kept as a reference for the benchmarks.
+    /// @remarks For concave vertices, the result is on the wrong side of the edge, unlike compute().
+    void computeReference(std::span<const Vertex> polygon, float thickness, std::span<glm::vec2> outer);
+}
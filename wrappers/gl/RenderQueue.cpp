@@ -0,0 +1,216 @@
+#include "RenderQueue.hpp"
+#include "Indices.hpp"
+#include <algorithm>
+#include <array>
+
+namespace
+{
+    // Position of the fields in the key
+    constexpr int layerShift = 56;
+    constexpr int shaderShift = 48;
+    constexpr int textureShift = 32;
+    constexpr int blendShift = 30;
+    constexpr int textShift = 29;
+    constexpr int primitiveShift = 27;
+    constexpr int depthBits = 24;
+
+    constexpr std::uint64_t shaderMask = std::uint64_t{0xff} << shaderShift;
+    constexpr std::uint64_t textureMask = std::uint64_t{0xffff} << textureShift;
+
+    std::uint64_t getPrimitiveNumber(GLenum listPrimitive)
+    {
+        switch(listPrimitive)
+        {
+            case GL_POINTS:
+                return 0;
+            case GL_LINES:
+                return 1;
+            default:
+                return 2;
+        }
+    }
+}
+
+template<typename T>
+std::uint64_t RenderQueue::getNumber(std::unordered_map<const T*, std::uint64_t>& numbers, const T *pointer,
+                                     std::uint64_t max)
+{
+    const auto [it, inserted] = numbers.try_emplace(pointer, std::min<std::uint64_t>(numbers.size(), max));
+    return it->second;
+}
+
+void RenderQueue::record(const RenderStates& states, const Texture *texture, GLenum primitive,
+                         std::span<const Vertex> vertices, std::span<const std::uint32_t> elements,
+                         const glm::vec4& color, bool text)
+{
+    if(!states.shader || vertices.empty())
+    {
+        return;
+    }
+
+    Command command;
+    command.shader = states.shader;
+    command.texture = texture;
+    command.primitive = Indices::getListPrimitive(primitive);
+    command.text = text;
+    command.blendMode = states.blendMode;
+
+    // Usually all the commands have the same view
+    if(m_views.empty() || m_views.back() != states.view)
+    {
+        m_views.push_back(states.view);
+    }
+
+    command.view = static_cast<std::uint32_t>(m_views.size() - 1);
+
+    const float depth = std::clamp(states.depth, 0.0f, 1.0f);
+
+    command.key = static_cast<std::uint64_t>(states.layer) << layerShift
+        | getNumber(m_shaders, states.shader, 0xff) << shaderShift
+        | getNumber(m_textures, texture, 0xffff) << textureShift
+        | static_cast<std::uint64_t>(states.blendMode) << blendShift
+        | static_cast<std::uint64_t>(text) << textShift
+        | getPrimitiveNumber(command.primitive) << primitiveShift
+        | static_cast<std::uint64_t>(depth * ((1 << depthBits) - 1));
+
+    command.firstVertex = static_cast<std::uint32_t>(m_vertices.size());
+    command.vertexCount = static_cast<std::uint32_t>(vertices.size());
+    command.firstIndex = static_cast<std::uint32_t>(m_indices.size());
+
+    for(const Vertex& vertex : vertices)
+    {
+        // The transformation is 2D, so z = 0 and w = 1 are preserved
+        const glm::vec4 pos = states.model * glm::vec4(vertex.pos, 0.0f, 1.0f);
+
+        Vertex& v = m_vertices.emplace_back(vertex);
+        v.pos = {pos.x, pos.y};
+        v.color = vertex.color * color;
+    }
+
+    if(elements.empty())
+    {
+        Indices::append(primitive, vertices.size(), 0, m_indices);
+    }
+    else
+    {
+        Indices::append(primitive, elements, 0, m_indices);
+    }
+
+    command.indexCount = static_cast<std::uint32_t>(m_indices.size()) - command.firstIndex;
+    m_commands.push_back(command);
+}
+
+void RenderQueue::append(const RenderQueue& other)
+{
+    const auto vertexOffset = static_cast<std::uint32_t>(m_vertices.size());
+    const auto indexOffset = static_cast<std::uint32_t>(m_indices.size());
+    const auto viewOffset = static_cast<std::uint32_t>(m_views.size());
+
+    m_vertices.insert(m_vertices.end(), other.m_vertices.begin(), other.m_vertices.end());
+    m_indices.insert(m_indices.end(), other.m_indices.begin(), other.m_indices.end());
+    m_views.insert(m_views.end(), other.m_views.begin(), other.m_views.end());
+
+    for(Command command : other.m_commands)
+    {
+        // The shaders and textures are numbered by each queue, they should be numbered again by this one
+        command.key = (command.key & ~(shaderMask | textureMask))
+            | getNumber(m_shaders, command.shader, 0xff) << shaderShift
+            | getNumber(m_textures, command.texture, 0xffff) << textureShift;
+
+        command.firstVertex += vertexOffset;
+        command.firstIndex += indexOffset;
+        command.view += viewOffset;
+
+        m_commands.push_back(command);
+    }
+}
+
+std::span<const RenderQueue::Command> RenderQueue::getCommands() const
+{
+    return m_commands;
+}
+
+std::span<const RenderQueue::Command> RenderQueue::sort()
+{
+    m_items.resize(m_commands.size());
+    m_swap.resize(m_commands.size());
+
+    for(std::size_t i = 0; i < m_commands.size(); ++i)
+    {
+        m_items[i] = {m_commands[i].key, static_cast<std::uint32_t>(i)};
+    }
+
+    // LSD radix sort, one byte per pass. Each pass is stable, so the order of the calls is kept for equal keys
+    for(int shift = 0; shift < 64; shift += 8)
+    {
+        std::array<std::size_t, 256> offsets{};
+
+        for(const SortItem& item : m_items)
+        {
+            offsets[(item.key >> shift) & 0xff]++;
+        }
+
+        // All the keys have the same byte, the pass would not change the order
+        if(std::find(offsets.begin(), offsets.end(), m_items.size()) != offsets.end())
+        {
+            continue;
+        }
+
+        std::size_t offset = 0;
+
+        for(std::size_t& count : offsets)
+        {
+            offset += count;
+            count = offset - count;
+        }
+
+        for(const SortItem& item : m_items)
+        {
+            m_swap[offsets[(item.key >> shift) & 0xff]++] = item;
+        }
+
+        std::swap(m_items, m_swap);
+    }
+
+    m_sorted.clear();
+
+    for(const SortItem& item : m_items)
+    {
+        m_sorted.push_back(m_commands[item.command]);
+    }
+
+    return m_sorted;
+}
+
+std::span<const Vertex> RenderQueue::getVertices(const Command& command) const
+{
+    return std::span<const Vertex>(m_vertices).subspan(command.firstVertex, command.vertexCount);
+}
+
+std::span<const std::uint32_t> RenderQueue::getIndices(const Command& command) const
+{
+    return std::span<const std::uint32_t>(m_indices).subspan(command.firstIndex, command.indexCount);
+}
+
+const glm::mat4& RenderQueue::getView(const Command& command) const
+{
+    return m_views[command.view];
+}
+
+bool RenderQueue::isEmpty() const
+{
+    return m_commands.empty();
+}
+
+void RenderQueue::clear()
+{
+    m_commands.clear();
+    m_vertices.clear();
+    m_indices.clear();
+    m_views.clear();
+
+    // Numbered again from 0, otherwise the maps would grow with every texture ever drawn, and keep the addresses of
+    // destroyed ones which can be reused by new textures
+    m_shaders.clear();
+    m_textures.clear();
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "RenderStates.hpp"
+#include "Texture.hpp"
+#include "Vertex.hpp"
+#include <wrappers/gl/GL.hpp>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+/// @brief Draw commands recorded during a frame, to be sorted by state before being submitted.
+/// @details
+/// Each command gets a 64-bit key, from the most to the least significant bits:
+/// the layer (8 bits), the shader (8 bits), the texture (16 bits), the blend mode (2 bits), the text flag (1 bit),
+/// the list primitive (2 bits), 3 unused bits, and the depth (24 bits).
+/// The shaders and textures are numbered in the order they are first recorded since the last clear(), so the key
+/// does not depend on their addresses, and the numbers stay dense as long as the queue is cleared every frame. The
+/// keys are sorted with a stable LSD radix sort, the passes where all the keys have the same byte are skipped, so
+/// usually only a few passes are done.
+/// The geometry is transformed and colored when it is recorded, like in the batch of the Renderer, so the commands
+/// with the same key can be concatenated in a single draw call.
+class RenderQueue
+{
+public:
+    /// @brief A recorded geometry.
+    struct Command
+    {
+        std::uint64_t key;
+        Shader *shader;
+        const Texture *texture;
+        GLenum primitive; ///< List primitive: GL_TRIANGLES, GL_LINES or GL_POINTS.
+        bool text;
+        BlendMode blendMode;
+        std::uint32_t view; ///< Index of the view matrix.
+        std::uint32_t firstVertex;
+        std::uint32_t vertexCount;
+        std::uint32_t firstIndex; ///< The indices are relative to the first vertex.
+        std::uint32_t indexCount;
+    };
+
+    /// @brief Record a geometry, see Renderer::draw().
+    /// @param elements The indices of the vertices, or empty to draw all the vertices in order.
+    void record(const RenderStates& states, const Texture *texture, GLenum primitive,
+                std::span<const Vertex> vertices, std::span<const std::uint32_t> elements,
+                const glm::vec4& color, bool text);
+
+    /// @brief Append the commands of another queue, after the commands of this one.
+    /// @details The geometry is copied. Used to merge the queues recorded by different threads.
+    void append(const RenderQueue& other);
+
+    /// @returns The commands in the order they were recorded.
+    std::span<const Command> getCommands() const;
+
+    /// @brief Sort the commands by key.
+    /// @returns The commands in the order to draw them.
+    std::span<const Command> sort();
+
+    std::span<const Vertex> getVertices(const Command& command) const;
+    std::span<const std::uint32_t> getIndices(const Command& command) const;
+    const glm::mat4& getView(const Command& command) const;
+
+    bool isEmpty() const;
+
+    /// @brief Remove the commands, and forget the numbers of the shaders and textures.
+    void clear();
+
+private:
+    /// @returns The number of a pointer, in the order of the first call, saturated to the maximum.
+    template<typename T>
+    static std::uint64_t getNumber(std::unordered_map<const T*, std::uint64_t>& numbers, const T *pointer,
+                                   std::uint64_t max);
+
+    /// @brief What is sorted, smaller than a Command.
+    struct SortItem
+    {
+        std::uint64_t key;
+        std::uint32_t command;
+    };
+
+    std::vector<Command> m_commands;
+    std::vector<Command> m_sorted;
+    std::vector<SortItem> m_items;
+    std::vector<SortItem> m_swap; ///< Temporary buffer of the radix sort.
+    std::vector<Vertex> m_vertices; ///< Transformed and colored.
+    std::vector<std::uint32_t> m_indices;
+    std::vector<glm::mat4> m_views;
+
+    std::unordered_map<const Shader*, std::uint64_t> m_shaders;
+    std::unordered_map<const Texture*, std::uint64_t> m_textures;
+};
@@ -2,6 +2,17 @@
 
 #include "Shader.hpp"
 #include <glm/glm.hpp>
+#include <cstdint>
+
+class Renderer;
+
+/// @brief How the fragments are combined with the framebuffer.
+enum class BlendMode : std::uint8_t
+{
+    Alpha, ///< Standard transparency, the default of the Window.
+    Add, ///< The colors are added, weighted by the alpha, for lights and particles.
+    None ///< Opaque, the fragments replace the framebuffer.
+};
 
 struct RenderStates
 {
@@ -9,5 +20,33 @@ struct RenderStates
 
     glm::mat4 view{1.0f};
     glm::mat4 model{1.0f};
-};
 
+    /// @brief If not null, the drawables submit their geometry to the renderer to be batched,
+    /// instead of issuing their own draw calls.
+    Renderer *renderer{nullptr};
+
+    /// @brief If the drawables outside the view are skipped, see Bounds::isVisible().
+    bool culling{true};
+
+    /// @brief Size of the viewport in pixels, for the geometry depending on its size on the screen, like adaptive
+    /// circles.
+    /// @details If zero, the viewport of the GL state cache is used, which is only valid on the thread owning the
+    /// context. It should be set when the geometry is captured on another thread, see Renderer::setCapture().
+    glm::ivec2 viewport{0};
+
+    /// @name
+    /// @brief Only used by a Renderer, see Renderer::setSorting().
+    /// @{
+
+    /// @brief When sorted, the layers are drawn in increasing order, so the geometries that overlap should be in
+    /// different layers. In a layer, the geometries are grouped by shader, texture and blend mode.
+    std::uint8_t layer{0};
+
+    /// @brief When sorted, the order of the geometries with the same layer and states, in [0, 1].
+    /// @details For equal depths, the order of the calls is kept.
+    float depth{0.0f};
+
+    BlendMode blendMode{BlendMode::Alpha};
+
+    /// @}
+};
@@ -0,0 +1,394 @@
+#include "Renderer.hpp"
+#include "Drawable.hpp"
+#include "Indices.hpp"
+#include "StreamBuffer.hpp"
+#include "TransformStore.hpp"
+#include <utility/Exception.hpp>
+#include <utility/Guard.hpp>
+#include <utility/Str.hpp>
+#include <utility/ThreadPool.hpp>
+
+namespace
+{
+    /// @brief Where the current thread records, while in Renderer::record().
+    struct Recording
+    {
+        RenderQueue *queue{nullptr};
+        Renderer::Stats *stats{nullptr};
+    };
+
+    thread_local Recording recording;
+}
+
+Renderer::Renderer()
+{
+    m_vertices.reserve(maxVertices);
+    m_indices.reserve(maxVertices);
+}
+
+void Renderer::draw(const RenderStates& states, const Texture *texture, GLenum primitive,
+                    std::span<const Vertex> vertices, const glm::vec4& color, bool text)
+{
+    if(RenderQueue *queue = getQueue())
+    {
+        getThreadStats().submitted += states.shader && !vertices.empty();
+        queue->record(states, texture, primitive, vertices, {}, color, text);
+        return;
+    }
+
+    if(const auto first = push(states, texture, primitive, vertices, color, text))
+    {
+        // Convert to a list primitive so that consecutive geometries do not connect to each other
+        Indices::append(primitive, vertices.size(), *first, m_indices);
+    }
+}
+
+void Renderer::draw(const RenderStates& states, const Texture *texture, GLenum primitive,
+                    std::span<const Vertex> vertices, std::span<const std::uint32_t> elements,
+                    const glm::vec4& color, bool text)
+{
+    if(elements.empty())
+    {
+        return;
+    }
+
+    if(RenderQueue *queue = getQueue())
+    {
+        getThreadStats().submitted += states.shader && !vertices.empty();
+        queue->record(states, texture, primitive, vertices, elements, color, text);
+        return;
+    }
+
+    if(const auto first = push(states, texture, primitive, vertices, color, text))
+    {
+        Indices::append(primitive, elements, *first, m_indices);
+    }
+}
+
+std::optional<std::uint32_t> Renderer::push(const RenderStates& states, const Texture *texture, GLenum primitive,
+                                            std::span<const Vertex> vertices, const glm::vec4& color, bool text)
+{
+    if(!states.shader || vertices.empty())
+    {
+        return std::nullopt;
+    }
+
+    m_stats.submitted++;
+
+    Batch batch;
+    batch.shader = states.shader;
+    batch.texture = texture;
+    batch.primitive = Indices::getListPrimitive(primitive);
+    batch.text = text;
+    batch.blendMode = states.blendMode;
+    batch.view = states.view;
+
+    prepare(batch, vertices.size());
+
+    const auto first = static_cast<std::uint32_t>(m_vertices.size());
+    const glm::mat4& model = states.model;
+
+    for(const Vertex& vertex : vertices)
+    {
+        // The transformation is 2D, so z = 0 and w = 1 are preserved
+        const glm::vec4 pos = model * glm::vec4(vertex.pos, 0.0f, 1.0f);
+
+        Vertex& v = m_vertices.emplace_back(vertex);
+        v.pos = {pos.x, pos.y};
+        v.color = vertex.color * color;
+    }
+
+    return first;
+}
+
+void Renderer::prepare(const Batch& batch, std::size_t count)
+{
+    if(!(batch == m_batch) || m_vertices.size() + count > maxVertices)
+    {
+        flushBatch();
+        m_batch = batch;
+    }
+}
+
+void Renderer::record(ThreadPool& pool, std::span<const Drawable* const> drawables, RenderStates states)
+{
+    // Nothing below should call OpenGL, or modify what is shared between the drawables:
+    // the matrices are all computed before, so they are only read while recording,
+    TransformStore::getGlobal().update(&pool);
+
+    // and the viewport is known, in case it is needed by the geometry (like adaptive circles). The GL state cache is
+    // only read here, on the calling thread, and only if the viewport is not given.
+    if(states.viewport == glm::ivec2{0})
+    {
+        const GL::Viewport& viewport = GL::getViewport();
+        states.viewport = {viewport.width, viewport.height};
+    }
+
+    states.renderer = this;
+
+    const std::size_t listCount = std::min<std::size_t>(pool.getConcurrency(), drawables.size());
+    const std::size_t listSize = listCount == 0 ? 0 : (drawables.size() + listCount - 1) / listCount;
+
+    if(m_commandLists.size() < listCount)
+    {
+        m_commandLists.resize(listCount);
+    }
+
+    // Each list is a contiguous range of the drawables, so the lists in order are the drawables in order
+    pool.parallelFor(listCount, [&](std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin; i < end; ++i)
+        {
+            CommandList& list = m_commandLists[i];
+            list.queue.clear();
+            list.stats = {};
+
+            recording = {&list.queue, &list.stats};
+
+            WhenLeaveScope {
+                recording = {};
+            };
+
+            const std::size_t last = std::min(drawables.size(), (i + 1) * listSize);
+
+            for(std::size_t j = i * listSize; j < last; ++j)
+            {
+                drawables[j]->draw(states);
+            }
+        }
+    });
+
+    RenderQueue& queue = m_capture ? *m_capture : m_queue;
+
+    for(std::size_t i = 0; i < listCount; ++i)
+    {
+        const CommandList& list = m_commandLists[i];
+
+        queue.append(list.queue);
+        m_stats.submitted += list.stats.submitted;
+        m_stats.drawn += list.stats.drawn;
+        m_stats.culled += list.stats.culled;
+    }
+
+    // Drawn in order like any other geometry, otherwise sorted with the rest of the frame at the next flush
+    if(!m_sorting && !m_capture)
+    {
+        submitQueue();
+    }
+}
+
+RenderQueue *Renderer::getQueue()
+{
+    if(recording.queue)
+    {
+        return recording.queue;
+    }
+
+    if(m_capture)
+    {
+        return m_capture;
+    }
+
+    return m_sorting ? &m_queue : nullptr;
+}
+
+Renderer::Stats& Renderer::getThreadStats()
+{
+    return recording.stats ? *recording.stats : m_stats;
+}
+
+void Renderer::flush()
+{
+    if(recording.queue || m_capture)
+    {
+        throw Exception(Str{} << "Renderer::flush() called while " << (m_capture ? "capturing" : "recording")
+                              << ", only the drawables that are batched can be recorded without OpenGL");
+    }
+
+    submitQueue();
+    flushBatch();
+}
+
+void Renderer::submitQueue()
+{
+    if(!m_queue.isEmpty())
+    {
+        for(const RenderQueue::Command& command : m_sorting ? m_queue.sort() : m_queue.getCommands())
+        {
+            Batch batch;
+            batch.shader = command.shader;
+            batch.texture = command.texture;
+            batch.primitive = command.primitive;
+            batch.text = command.text;
+            batch.blendMode = command.blendMode;
+            batch.view = m_queue.getView(command);
+
+            prepare(batch, command.vertexCount);
+
+            // Already transformed and colored when recorded
+            const auto first = static_cast<std::uint32_t>(m_vertices.size());
+            const std::span<const Vertex> vertices = m_queue.getVertices(command);
+            m_vertices.insert(m_vertices.end(), vertices.begin(), vertices.end());
+
+            for(std::uint32_t index : m_queue.getIndices(command))
+            {
+                m_indices.push_back(first + index);
+            }
+        }
+
+        m_queue.clear();
+    }
+}
+
+void Renderer::flushBatch()
+{
+    if(m_indices.empty())
+    {
+        m_vertices.clear();
+        return;
+    }
+
+    Shader *shader = m_batch.shader;
+
+    if(m_drawn)
+    {
+        m_stats.stateChanges += (m_drawn->shader != m_batch.shader) + (m_drawn->texture != m_batch.texture)
+            + (m_drawn->blendMode != m_batch.blendMode) + (m_drawn->text != m_batch.text);
+    }
+
+    m_drawn = m_batch;
+
+    Shader::bind(shader);
+    Texture::bind(m_batch.texture);
+    setBlendMode(m_batch.blendMode);
+
+    // The geometry is already in world space and colored
+    shader->setUniform("u_ModelMatrix", glm::mat4{1.0f});
+    shader->setUniform("u_ViewMatrix", m_batch.view);
+    shader->setUniform("u_Color", glm::vec4{1.0f});
+    shader->setUniform("u_Text", m_batch.text);
+
+    // The vertices are written directly in GPU memory, without waiting for the previous draw calls
+    StreamBuffer& stream = StreamBuffer::getGlobal();
+
+    // 16-bit, unless a single geometry has more vertices than the batch limit
+    const GLenum type = Indices::getType(m_vertices.size());
+
+    const StreamBuffer::IndexedGeometry geometry = stream.write(m_vertices, m_vertexFormat, m_indices, type);
+    stream.bindVertexArray(m_vertexFormat);
+
+    glDrawElementsBaseVertex(m_batch.primitive, static_cast<GLsizei>(m_indices.size()), type,
+                             reinterpret_cast<const void*>(geometry.indices), geometry.first);
+
+    // The drawables that are not batched expect the blending of the Window
+    setBlendMode(BlendMode::Alpha);
+
+    m_stats.drawCalls++;
+    m_stats.vertices += static_cast<int>(m_vertices.size());
+    m_stats.indices += static_cast<int>(m_indices.size());
+
+    m_vertices.clear();
+    m_indices.clear();
+}
+
+void Renderer::setCapture(RenderQueue *queue)
+{
+    if(!m_capture)
+    {
+        flush();
+    }
+
+    m_capture = queue;
+}
+
+void Renderer::submit(RenderQueue& queue)
+{
+    flush();
+
+    // The queue becomes the queue of the renderer, so the geometry is not copied
+    std::swap(m_queue, queue);
+    submitQueue();
+    flushBatch();
+    std::swap(m_queue, queue);
+}
+
+void Renderer::setSorting(bool sorting)
+{
+    if(m_sorting != sorting)
+    {
+        // Nothing to flush while capturing, everything is in the captured queue
+        if(!m_capture)
+        {
+            flush();
+        }
+
+        m_sorting = sorting;
+    }
+}
+
+bool Renderer::isSorting() const
+{
+    return m_sorting;
+}
+
+void Renderer::setBlendMode(BlendMode mode)
+{
+    switch(mode)
+    {
+        case BlendMode::Alpha:
+            GL::setBlending(true);
+            GL::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            break;
+
+        case BlendMode::Add:
+            GL::setBlending(true);
+            GL::blendFunc(GL_SRC_ALPHA, GL_ONE);
+            break;
+
+        case BlendMode::None:
+            GL::setBlending(false);
+            break;
+    }
+}
+
+void Renderer::setVertexFormat(Vertex::Format format)
+{
+    if(m_vertexFormat != format)
+    {
+        if(!m_capture)
+        {
+            flush();
+        }
+
+        m_vertexFormat = format;
+    }
+}
+
+Vertex::Format Renderer::getVertexFormat() const
+{
+    return m_vertexFormat;
+}
+
+void Renderer::countObject(bool visible)
+{
+    Stats& stats = getThreadStats();
+
+    if(visible)
+    {
+        ++stats.drawn;
+    }
+    else
+    {
+        ++stats.culled;
+    }
+}
+
+const Renderer::Stats& Renderer::getStats() const
+{
+    return m_stats;
+}
+
+void Renderer::resetStats()
+{
+    m_stats = {};
+    m_drawn.reset();
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+#include "RenderQueue.hpp"
+#include "RenderStates.hpp"
+#include "Texture.hpp"
+#include "Vertex.hpp"
+#include <wrappers/gl/GL.hpp>
+#include <glm/glm.hpp>
+#include <optional>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+class Drawable;
+class ThreadPool;
+
+/// @brief Automatic draw batching.
+/// @details
+/// Collects the geometry of many drawables into the global StreamBuffer, and issues a single draw call
+/// for all consecutive drawables sharing the same shader, texture, primitive type, text flag and view.
+/// The batch is indexed: each vertex is stored once, and strips, fans and loops are converted to lists only in the
+/// indices (see Indices), so a fan of n vertices costs n vertices instead of 3(n - 2).
+/// The model transform and the color of each drawable are applied on the CPU when the geometry is submitted,
+/// so the whole batch is drawn with an identity model matrix and an opaque white color.
+/// To use it, set RenderStates::renderer: the existing Drawable::draw(RenderStates) calls are unchanged.
+/// The batch is also flushed automatically when the batching state changes, but flush() should be called
+/// at the end of the frame (before rendering anything that does not go through the renderer, like ImGui).
+/// In sorted mode, the geometries are recorded in a RenderQueue instead, and sorted by layer and state when flushed,
+/// so that interleaved drawables with different textures or shader flags still share draw calls.
+class Renderer
+{
+public:
+    /// @brief Per-frame counters.
+    struct Stats
+    {
+        int submitted{0}; ///< Draw calls that would have been issued without batching.
+        int drawCalls{0}; ///< Draw calls actually issued.
+        int vertices{0}; ///< Vertices uploaded.
+        int indices{0}; ///< Indices uploaded.
+        int drawn{0}; ///< Drawables inside the view.
+        int culled{0}; ///< Drawables skipped because they were outside the view.
+        int stateChanges{0}; ///< Changes of shader, texture, blend mode or text flag between draw calls.
+    };
+
+    Renderer();
+
+    /// @brief Submit geometry to be drawn.
+    /// @param states The states of the drawable. The model matrix should already contain the drawable transform.
+    /// @param texture The texture, nullptr for no texture (opaque white).
+    /// @param primitive The primitive of the geometry. Strips, loops and fans are converted to lists so they can
+    /// be concatenated.
+    /// @param vertices The vertices, in local space.
+    /// @param color Color multiplied with each vertex color (same as the u_Color uniform).
+    /// @param text If the texture is a glyph atlas (same as the u_Text uniform).
+    void draw(const RenderStates& states, const Texture *texture, GLenum primitive,
+              std::span<const Vertex> vertices, const glm::vec4& color = glm::vec4{1.0f}, bool text = false);
+
+    /// @brief Submit indexed geometry to be drawn.
+    /// @param elements The indices in vertices, drawn with the primitive.
+    void draw(const RenderStates& states, const Texture *texture, GLenum primitive,
+              std::span<const Vertex> vertices, std::span<const std::uint32_t> elements,
+              const glm::vec4& color = glm::vec4{1.0f}, bool text = false);
+
+    /// @brief Issue the draw calls for everything submitted since the last flush.
+    /// @details In sorted mode, the recorded geometries are sorted and batched first.
+    /// @throws Exception If capturing or recording, since there is no draw call to issue.
+    void flush();
+
+    /// @brief Draw many drawables, recording their geometry in parallel on the threads of a pool.
+    /// @details
+    /// The drawables are split in contiguous ranges, and each thread records its range in its own RenderQueue with
+    /// states.renderer set to this renderer: the matrix products, the vertex generation and the culling are all
+    /// done in parallel. Then the queues are merged in order on the calling thread, and drawn like any other
+    /// geometry: immediately if not sorted, otherwise at the next flush().
+    /// The global TransformStore is updated before, so the transforms are only read while recording.
+    /// Should be called from the thread owning the GL context, unless capturing with RenderStates::viewport set:
+    /// then OpenGL and its state cache are not used at all.
+    /// @param drawables Should only submit geometry to the renderer, without using OpenGL or modifying what they
+    /// share: Shape (except SDF circles), Text, RichText or VertexArray. A drawable should appear only once, and the
+    /// glyphs of the texts should already be loaded, for example by a previous draw or by Text::getSize().
+    /// @throws Exception If a drawable flushes the renderer, like the drawables that are not batched.
+    /// @remarks When capturing, the geometries are merged in the captured queue instead.
+    void record(ThreadPool& pool, std::span<const Drawable* const> drawables, RenderStates states);
+
+    /// @brief Record all the geometries in a queue instead of drawing them, to draw them on another thread.
+    /// @details Nothing is drawn while capturing, so no OpenGL context is needed: the queue can be drawn later with
+    /// submit(), by a renderer on the thread owning the context (see RenderThread).
+    /// Like with record(), only the drawables that are batched can be captured.
+    /// @param queue The destination, nullptr to stop capturing. The current geometries are flushed before.
+    void setCapture(RenderQueue *queue);
+
+    /// @brief Draw the geometries of a queue, sorted if this renderer is sorting.
+    /// @details The queue is cleared, but keeps its memory.
+    void submit(RenderQueue& queue);
+
+    /// @brief Set if the geometries are sorted by state before being drawn. The default is false.
+    /// @details When sorted, the order of the calls is only kept between geometries with the same states, the order
+    /// of the drawables that overlap should be given by RenderStates::layer. The drawables that are not batched flush
+    /// the renderer before drawing, so they are still drawn in order with the others.
+    /// Otherwise, the geometries are drawn in the order of the calls, and a new batch is started each time the state
+    /// changes. The current geometries are flushed.
+    void setSorting(bool sorting);
+    bool isSorting() const;
+
+    /// @brief Set the layout of the vertices in the batch buffer. Full by default.
+    /// @details The current batch is flushed.
+    void setVertexFormat(Vertex::Format format);
+    Vertex::Format getVertexFormat() const;
+
+    /// @brief Count a drawable in the stats, after the culling pass.
+    void countObject(bool visible);
+
+    const Stats& getStats() const;
+
+    /// @brief Reset the counters. Should be called once per frame.
+    void resetStats();
+
+private:
+    /// @brief The states that cannot change inside a single draw call.
+    struct Batch
+    {
+        Shader *shader{nullptr};
+        const Texture *texture{nullptr};
+        GLenum primitive{GL_TRIANGLES};
+        bool text{false};
+        BlendMode blendMode{BlendMode::Alpha};
+        glm::mat4 view{1.0f};
+
+        bool operator==(const Batch& other) const = default;
+    };
+
+    /// @brief Maximum count of vertices in the batch before it is flushed.
+    static constexpr std::size_t maxVertices = 1 << 16;
+
+    /// @brief Flush if the geometry cannot be added to the current batch, and append its vertices.
+    /// @returns The index of the first vertex in the batch, or nothing if there is nothing to draw.
+    std::optional<std::uint32_t> push(const RenderStates& states, const Texture *texture, GLenum primitive,
+                                      std::span<const Vertex> vertices, const glm::vec4& color, bool text);
+
+    /// @brief Start a new batch if the states differ or if there is not enough room for count vertices.
+    void prepare(const Batch& batch, std::size_t count);
+
+    /// @brief Issue the draw call for the current batch, if there is one.
+    void flushBatch();
+
+    /// @brief Add the recorded geometries to the batches, sorted or not.
+    void submitQueue();
+
+    /// @returns Where the geometries should be recorded by the calling thread, nullptr to batch them immediately.
+    RenderQueue *getQueue();
+
+    /// @returns The counters of the calling thread.
+    Stats& getThreadStats();
+
+    /// @brief Apply the blend mode with the GL state cache.
+    static void setBlendMode(BlendMode mode);
+
+    Batch m_batch;
+    std::optional<Batch> m_drawn; ///< The states of the last draw call, to count the state changes.
+    std::vector<Vertex> m_vertices; ///< CPU side of the batch, already in world space.
+    std::vector<std::uint32_t> m_indices; ///< Indices in m_vertices, as the batch primitive.
+    Vertex::Format m_vertexFormat{Vertex::Format::Full};
+
+    bool m_sorting{false};
+    RenderQueue m_queue;
+    RenderQueue *m_capture{nullptr};
+
+    /// @brief The geometries recorded by a thread, see record().
+    struct CommandList
+    {
+        RenderQueue queue;
+        Stats stats;
+    };
+
+    std::vector<CommandList> m_commandLists; ///< Kept from frame to frame, to reuse their memory.
+
+    Stats m_stats;
+};
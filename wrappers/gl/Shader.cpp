@@ -2,7 +2,9 @@
 #include <utility/Exception.hpp>
 #include <utility/IO.hpp>
 #include <GL/glew.h>
+#include <utility/Str.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
 #include <vector>
 
 void Shader::load(const std::string& vertexSrc, const std::string& fragmentSrc)
@@ -76,39 +78,127 @@ void Shader::link(GL::Shader& vertex, GL::Shader& fragment)
     // The shaders are not needed anymore
     glDeleteShader(vertex);
     glDeleteShader(fragment);
+
+    introspect();
 }
 
-void Shader::bind(const Shader *shader)
+void Shader::introspect()
 {
-    if(shader)
+    m_uniforms.clear();
+
+    int count; // Count of active uniforms
+    glGetProgramiv(m_program, GL_ACTIVE_UNIFORMS, &count);
+
+    int maxLength; // Max length of the name of an uniform (including null-terminating char)
+    glGetProgramiv(m_program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    std::vector<char> name(maxLength, '\0');
+
+    for(int i = 0; i < count; ++i)
     {
-        glUseProgram(shader->m_program);
+        GLsizei length;
+        GLint size;
+        GLenum type;
+        glGetActiveUniform(m_program, i, maxLength, &length, &size, &type, &name[0]);
+
+        std::string_view view(name.data(), length);
+
+        // Arrays are reported as "name[0]", but can be accessed as "name"
+        if(view.ends_with("[0]"))
+        {
+            view.remove_suffix(3);
+        }
+
+        UniformInfo uniform{};
+        uniform.hash = hash(view);
+        uniform.location = glGetUniformLocation(m_program, name.data());
+
+        // Uniforms in uniform blocks have no location
+        if(uniform.location != -1)
+        {
+            m_uniforms.push_back(uniform);
+        }
     }
-    else
+
+    std::sort(m_uniforms.begin(), m_uniforms.end(), [](const UniformInfo& a, const UniformInfo& b) {
+        return a.hash < b.hash;
+    });
+
+    auto collision = std::adjacent_find(m_uniforms.begin(), m_uniforms.end(), [](const UniformInfo& a, const UniformInfo& b) {
+        return a.hash == b.hash;
+    });
+
+    if(collision != m_uniforms.end())
     {
-        glUseProgram(0);
+        throw Exception(Str{} << "Two uniforms have the same name hash " << collision->hash);
     }
 }
 
+int Shader::findUniform(std::uint32_t hash) const
+{
+    auto it = std::lower_bound(m_uniforms.begin(), m_uniforms.end(), hash, [](const UniformInfo& a, std::uint32_t hash) {
+        return a.hash < hash;
+    });
+
+    if(it == m_uniforms.end() || it->hash != hash)
+    {
+        return -1;
+    }
+
+    return static_cast<int>(it - m_uniforms.begin());
+}
+
+void Shader::bind(const Shader *shader)
+{
+    GL::useProgram(shader ? shader->m_program.id : 0);
+}
+
 void Shader::bind()
 {
     bind(this);
 }
 
-void Shader::setUniform(const std::string& name, const glm::mat4& value)
+void Shader::setUniform(UniformName name, const glm::mat4& value)
+{
+    getUniform<glm::mat4>(name).set(value);
+}
+
+void Shader::setUniform(UniformName name, float value)
+{
+    getUniform<float>(name).set(value);
+}
+
+void Shader::setUniform(UniformName name, int value)
+{
+    getUniform<int>(name).set(value);
+}
+
+void Shader::setUniform(UniformName name, const glm::vec4& value)
+{
+    getUniform<glm::vec4>(name).set(value);
+}
+
+void Shader::upload(GLint location, const glm::mat4& value)
+{
+    glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void Shader::upload(GLint location, const glm::vec4& value)
+{
+    glUniform4fv(location, 1, glm::value_ptr(value));
+}
+
+void Shader::upload(GLint location, const glm::vec2& value)
 {
-    bind();
-    glUniformMatrix4fv(glGetUniformLocation(m_program, name.c_str()), 1, GL_FALSE, glm::value_ptr(value));
+    glUniform2fv(location, 1, glm::value_ptr(value));
 }
 
-void Shader::setUniform(const std::string& name, int value)
+void Shader::upload(GLint location, float value)
 {
-    bind();
-    glUniform1i(glGetUniformLocation(m_program, name.c_str()), value);
+    glUniform1f(location, value);
 }
 
-void Shader::setUniform(const std::string& name, const glm::vec4& value)
+void Shader::upload(GLint location, int value)
 {
-    bind();
-    glUniform4fv(glGetUniformLocation(m_program, name.c_str()), 1, glm::value_ptr(value));
+    glUniform1i(location, value);
 }
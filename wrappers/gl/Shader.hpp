@@ -3,13 +3,95 @@
 #include "GL.hpp"
 #include <glm/glm.hpp>
 #include <string>
+#include <string_view>
 #include <filesystem>
+#include <cstdint>
+#include <cstring>
+#include <vector>
 #include "Texture.hpp"
 
 /// @brief Represent all necessary for representing OpenGL shaders.
+/// @details
+/// After linking, all the active uniforms are introspected and cached, so that setting an uniform does not need
+/// to query its location. Uniforms are identified by the hash of their name, which is computed at compile time
+/// for string literals. Uploading the same value twice to an uniform is skipped.
 class Shader
 {
 public:
+    /// @brief Hash of the name of an uniform (32-bits FNV-1a).
+    static constexpr std::uint32_t hash(std::string_view name)
+    {
+        std::uint32_t h = 2166136261u;
+
+        for(char c : name)
+        {
+            h ^= static_cast<unsigned char>(c);
+            h *= 16777619u;
+        }
+
+        return h;
+    }
+
+    /// @brief Name of an uniform, only the hash is stored.
+    /// @details Implicitly constructible from a string literal, in this case the hash is computed at compile time.
+    class UniformName
+    {
+    public:
+        template<std::size_t N>
+        consteval UniformName(const char (&name)[N])
+            : m_hash(hash(std::string_view(name, N - 1)))
+        {
+        }
+
+        UniformName(const std::string& name)
+            : m_hash(hash(name))
+        {
+        }
+
+        std::uint32_t getHash() const { return m_hash; }
+
+    private:
+        std::uint32_t m_hash;
+    };
+
+    /// @brief Typed handle to an uniform of a shader.
+    /// @details Setting the value is only an index in the uniform cache of the shader plus one GL call.
+    /// If the uniform does not exist (or was optimized out by the GLSL compiler), the handle is invalid
+    /// and setting it does nothing, like OpenGL does with a location of -1.
+    /// @remarks The handle is invalidated when the shader is reloaded.
+    template<typename T>
+    class Uniform
+    {
+    public:
+        Uniform() = default;
+
+        bool isValid() const { return m_shader != nullptr; }
+
+        void set(const T& value) const
+        {
+            if(m_shader)
+            {
+                m_shader->set(m_index, value);
+            }
+        }
+
+        const Uniform& operator=(const T& value) const
+        {
+            set(value);
+            return *this;
+        }
+
+    private:
+        friend class Shader;
+
+        Uniform(Shader *shader, int index)
+            : m_shader(shader), m_index(index)
+        {
+        }
+
+        Shader *m_shader{nullptr};
+        int m_index{-1};
+    };
 
     /// @brief Try to load a shader.
     /// @param vertex,fragment The source code for each shader.
@@ -22,27 +104,84 @@ public:
     static void bind(const Shader* shader);
     void bind();
 
+    /// @brief Get a typed handle to an uniform.
+    /// @returns An invalid handle if there is no active uniform with this name.
+    template<typename T>
+    Uniform<T> getUniform(UniformName name)
+    {
+        const int index = findUniform(name.getHash());
+        return index < 0 ? Uniform<T>{} : Uniform<T>{this, index};
+    }
 
     /// @name
     /// @brief Set a uniform variable
     /// @{
 
-    void setUniform(const std::string& name, const glm::mat4 &value);
-    void setUniform(const std::string& name, const glm::vec4& value);
-    void setUniform(const std::string& name, int value);
+    void setUniform(UniformName name, const glm::mat4 &value);
+    void setUniform(UniformName name, const glm::vec4& value);
+    void setUniform(UniformName name, float value);
+    void setUniform(UniformName name, int value);
 
     /// @}
 
 private:
+    /// @brief Cached informations of an active uniform.
+    struct UniformInfo
+    {
+        std::uint32_t hash;
+        GLint location;
+        unsigned char value[sizeof(glm::mat4)]; ///< The last uploaded value.
+        bool hasValue{false}; ///< False until the first upload, to not rely on the value initialized by GL.
+    };
 
     static void compile(GL::Shader& shader, const std::string& source);
 
     void link(GL::Shader& vertex, GL::Shader& fragment);
 
+    /// @brief Fill the uniform cache with all the active uniforms of the linked program.
+    void introspect();
+
+    /// @returns The index of the uniform in the cache, or -1 if the uniform does not exist.
+    int findUniform(std::uint32_t hash) const;
+
+    /// @brief Set the value of an uniform from its index in the cache, if it changed.
+    template<typename T>
+    void set(int index, const T& value)
+    {
+        static_assert(sizeof(T) <= sizeof(UniformInfo::value));
+
+        UniformInfo& uniform = m_uniforms[index];
+
+        if(uniform.hasValue && std::memcmp(uniform.value, &value, sizeof(T)) == 0)
+        {
+            return;
+        }
+
+        uniform.hasValue = true;
+        std::memcpy(uniform.value, &value, sizeof(T));
+
+        bind();
+        upload(uniform.location, value);
+    }
+
+    /// @name
+    /// @brief Upload an uniform of the currently bound program.
+    /// @{
+
+    static void upload(GLint location, const glm::mat4& value);
+    static void upload(GLint location, const glm::vec4& value);
+    static void upload(GLint location, const glm::vec2& value);
+    static void upload(GLint location, float value);
+    static void upload(GLint location, int value);
+
+    /// @}
+
     /// @returns A string containing the compilation information of a shader (vertex or fragment).
     static std::string getShaderInfoLog(GL::Shader& shader);
     static std::string getProgramInfoLog(GL::Program& program);
 
     GL::Program m_program;
-};
 
+    /// @brief All the active uniforms, sorted by hash.
+    std::vector<UniformInfo> m_uniforms;
+};
@@ -1,6 +1,37 @@
 #include "Shape.hpp"
+#include "Indices.hpp"
+#include "Outline.hpp"
+#include "Renderer.hpp"
+#include "StreamBuffer.hpp"
+#include <utility/ThreadPool.hpp>
+#include <algorithm>
 #include <cstddef>
 
+namespace
+{
+    /// @brief Update the element buffer of a geometry drawn as primitive, if its count of vertices changed.
+    /// @param indexedCount The count of vertices the indices were built for, zero if not indexed.
+    void updateIndices(VertexBuffer& buffer, GLenum primitive, std::size_t count, bool indexed,
+                       std::size_t& indexedCount)
+    {
+        if(!indexed)
+        {
+            count = 0;
+        }
+
+        // The indices only depend on the count of vertices
+        if(indexedCount != count)
+        {
+            indexedCount = count;
+
+            std::vector<std::uint32_t> indices;
+            Indices::append(primitive, count, 0, indices);
+
+            buffer.setIndices(indices);
+        }
+    }
+}
+
 void Shape::setTexture(const Texture *texture)
 {
     m_texture = texture;
@@ -57,41 +88,103 @@ void Shape::draw(RenderStates states) const
 
     if(states.shader)
     {
+        if(!Bounds::isVisible(states, getGlobalBounds()))
+        {
+            return;
+        }
+
         states.model *= getTransform();
 
+        const auto count = static_cast<GLsizei>(m_vertices.size());
+
+        if(states.renderer)
+        {
+            // Same geometry, but merged with the other drawables of the renderer
+            if(count >= 2)
+            {
+                if(m_triangles.empty())
+                {
+                    states.renderer->draw(states, m_texture, count == 2 ? GL_LINES : GL_TRIANGLE_FAN, m_vertices, m_fillColor);
+                }
+                else
+                {
+                    states.renderer->draw(states, m_texture, GL_TRIANGLES, m_vertices, m_triangles, m_fillColor);
+                }
+
+                if(!m_outlineVertices.empty())
+                {
+                    states.renderer->draw(states, m_texture, GL_TRIANGLE_STRIP, m_outlineVertices, m_outlineColor);
+                }
+            }
+
+            return;
+        }
+
+        // Dynamic shapes are streamed at each draw instead
+        if(m_needUpload && !m_dynamic)
+        {
+            m_needUpload = false;
+            upload();
+        }
+
+        StreamBuffer *stream = m_dynamic ? &StreamBuffer::getGlobal() : nullptr;
+
         Shader::bind(states.shader);
         Texture::bind(m_texture);
 
         states.shader->setUniform("u_ModelMatrix", states.model);
         states.shader->setUniform("u_ViewMatrix", states.view);
 
-        const auto count = static_cast<GLsizei>(getVerticesCount());
-
         if(count >= 2) // Prevent crash for empty shapes
         {
             // Draw fill
             states.shader->setUniform("u_Color", m_fillColor);
-            glBindVertexArray(m_vao);
 
-            if(count == 2)
+            // Cannot draw triangles with 2 vertices...
+            // Assume it is a line in this case
+            const GLenum primitive = count == 2 ? GL_LINES : GL_TRIANGLE_FAN;
+
+            if(stream)
             {
-                // Cannot draw triangles with 2 vertices...
-                // Assume it is a line in this case
-                glDrawArrays(GL_LINES, 0, count);
+                if(m_triangles.empty())
+                {
+                    const GLint first = stream->write(m_vertices, m_vertexFormat);
+
+                    stream->bindVertexArray(m_vertexFormat);
+                    glDrawArrays(primitive, first, count);
+                }
+                else
+                {
+                    const GLenum type = Indices::getType(m_vertices.size());
+                    const StreamBuffer::IndexedGeometry geometry = stream->write(m_vertices, m_vertexFormat,
+                                                                                 m_triangles, type);
+
+                    stream->bindVertexArray(m_vertexFormat);
+                    glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(m_triangles.size()), type,
+                                             reinterpret_cast<const void*>(geometry.indices), geometry.first);
+                }
             }
             else
             {
-                glDrawArrays(GL_TRIANGLE_FAN, 0, count);
+                m_buffer.draw(m_buffer.isIndexed() ? Indices::getListPrimitive(primitive) : primitive);
             }
 
             // Draw outline if there is one
-            if (m_outlineThickness != 0.0f && count > 2)
+            if (!m_outlineVertices.empty())
             {
                 states.shader->setUniform("u_Color", m_outlineColor);
-                glBindVertexArray(m_outlineVao);
 
-                // + 1 because we need to close the shape>
-                glDrawArrays(GL_TRIANGLE_STRIP, 0, (count + 1) * 2);
+                if(stream)
+                {
+                    const GLint first = stream->write(m_outlineVertices, m_vertexFormat);
+
+                    // + 1 because we need to close the shape>
+                    glDrawArrays(GL_TRIANGLE_STRIP, first, (count + 1) * 2);
+                }
+                else
+                {
+                    m_outlineBuffer.draw(m_outlineBuffer.isIndexed() ? GL_TRIANGLES : GL_TRIANGLE_STRIP);
+                }
             }
         }
     }
@@ -99,53 +192,120 @@ void Shape::draw(RenderStates states) const
 
 void Shape::update() const
 {
-    std::vector<Vertex> vertices = getVertices();
+    const std::size_t count = getVerticesCount();
 
-    glBindVertexArray(m_vao);
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    if(m_needFullUpdate || count != m_vertices.size())
+    {
+        // Reuse the memory of the previous vertices
+        m_vertices.resize(count);
+        writeVertices(m_vertices);
+        m_uploadRange.add(0, count);
+    }
+    else
+    {
+        // Only some vertices were modified, like with ConvexShape::setVertex()
+        for(std::size_t i = m_dirtyVertices.begin; i < m_dirtyVertices.end; ++i)
+        {
+            m_vertices[i] = getVertex(static_cast<int>(i));
+        }
+
+        m_uploadRange.add(m_dirtyVertices.begin, m_dirtyVertices.end);
+    }
 
-    GL::bufferData(GL_ARRAY_BUFFER, vertices, getUsage());
-    Vertex::vertexAttribPointer();
+    m_needFullUpdate = false;
+    m_dirtyVertices.clear();
+
+    // Usually the same, only moving a vertex of a concave shape may change it
+    const std::span<const std::uint32_t> triangles = getTriangles();
+
+    if(!std::equal(triangles.begin(), triangles.end(), m_triangles.begin(), m_triangles.end()))
+    {
+        m_triangles.assign(triangles.begin(), triangles.end());
+        m_needTrianglesUpload = true;
+    }
 
     updateOutline();
+
+    // The outline is outside the fill if the thickness is positive, but it can also be inside
+    m_localBounds = Bounds::compute(m_vertices);
+
+    if(!m_outlineVertices.empty())
+    {
+        m_localBounds = Bounds::merge(m_localBounds, Bounds::compute(m_outlineVertices));
+    }
+
+    m_globalBounds.invalidate();
+
+    // The GPU buffers are only needed when the Shape is drawn without a Renderer
+    m_needUpload = true;
 }
 
 void Shape::updateOutline() const
 {
-    std::vector<Vertex> vertices;
+    // Each outline vertex depends on its neighbours, so it is simpler to find the modified ones after
+    std::swap(m_previousOutline, m_outlineVertices);
 
-    if(m_outlineThickness != 0.0f && getVerticesCount() > 2)
-    {
-        auto innerVertices = getVertices();
-        auto outerVertices = getOutlineVertices();
+    const std::size_t size = m_vertices.size();
 
-        // The ouline border have no color (Vertices color is white, and the color of the shader)
-        for(Vertex& v : innerVertices)
-        {
-            v.color = glm::vec4{1.0f};
-        }
+    if(m_outlineThickness != 0.0f && size > 2)
+    {
+        m_outerBorder.resize(size);
+        Outline::compute(m_vertices, m_outlineThickness, m_outerBorder, &ThreadPool::getGlobal());
 
-        assert(innerVertices.size() == outerVertices.size());
-        const std::size_t size = innerVertices.size();
+        // It will be rendered in order, so the inner and outer borders are intermixed
+        m_outlineVertices.resize(2 * size + 2);
 
-        // It will be rendered in order, so we need to intermix them
-        vertices.reserve(2 * size);
         for(std::size_t i = 0; i < size; ++i)
         {
-            vertices.push_back(innerVertices[i]);
-            vertices.push_back(outerVertices[i]);
+            // The ouline border have no color (Vertices color is white, and the color of the shader)
+            Vertex& inner = m_outlineVertices[2 * i];
+            inner = m_vertices[i];
+            inner.color = glm::vec4{1.0f};
+
+            m_outlineVertices[2 * i + 1] = Vertex{m_outerBorder[i]};
         }
 
         // Close the shape
-        vertices.push_back(innerVertices[0]);
-        vertices.push_back(outerVertices[0]);
+        m_outlineVertices[2 * size] = m_outlineVertices[0];
+        m_outlineVertices[2 * size + 1] = m_outlineVertices[1];
+    }
+    else
+    {
+        m_outlineVertices.clear();
     }
 
-    glBindVertexArray(m_outlineVao);
-    glBindBuffer(GL_ARRAY_BUFFER, m_outlineVbo);
+    m_outlineUploadRange.addChanges<Vertex>(m_previousOutline, m_outlineVertices);
+}
+
+void Shape::upload() const
+{
+    m_buffer.setFormat(m_vertexFormat);
+    m_buffer.update(m_vertices, m_uploadRange);
+    m_uploadRange.clear();
+
+    m_outlineBuffer.setFormat(m_vertexFormat);
+    m_outlineBuffer.update(m_outlineVertices, m_outlineUploadRange);
+    m_outlineUploadRange.clear();
 
-    GL::bufferData(GL_ARRAY_BUFFER, vertices, getUsage());
-    Vertex::vertexAttribPointer();
+    const std::size_t count = m_vertices.size();
+
+    if(!m_triangles.empty())
+    {
+        if(m_needTrianglesUpload)
+        {
+            m_buffer.setIndices(m_triangles);
+        }
+
+        // So that the fan indices are built again if the shape becomes convex
+        m_indexedCount = static_cast<std::size_t>(-1);
+    }
+    else
+    {
+        updateIndices(m_buffer, count == 2 ? GL_LINES : GL_TRIANGLE_FAN, count, m_indexed, m_indexedCount);
+    }
+
+    m_needTrianglesUpload = false;
+    updateIndices(m_outlineBuffer, GL_TRIANGLE_STRIP, m_outlineVertices.size(), m_indexed, m_indexedOutlineCount);
 }
 
 void Shape::setDynamic(bool dynamic)
@@ -162,70 +322,108 @@ bool Shape::isDynamic() const
     return m_dynamic;
 }
 
-std::vector<Vertex> Shape::getVertices() const
+void Shape::setIndexed(bool indexed)
 {
-    auto count = static_cast<std::size_t>(getVerticesCount());
+    if(m_indexed != indexed)
+    {
+        m_indexed = indexed;
+        m_needUpload = true;
+    }
+}
 
-    std::vector<Vertex> ret;
-    ret.reserve(count);
+bool Shape::isIndexed() const
+{
+    return m_indexed;
+}
 
-    for(int i = 0; i < count; ++i)
+void Shape::setVertexFormat(Vertex::Format format)
+{
+    if(m_vertexFormat != format)
     {
-        ret.emplace_back(getVertex(i));
+        m_vertexFormat = format;
+        m_needUpload = true;
     }
-
-    return ret;
 }
 
-std::vector<Vertex> Shape::getOutlineVertices() const
+Vertex::Format Shape::getVertexFormat() const
 {
-    std::vector<Vertex> vertices = getVertices();
-    std::vector<Vertex> outlines;
+    return m_vertexFormat;
+}
 
-    if(vertices.size() > 2)
+void Shape::writeVertices(std::span<Vertex> vertices) const
+{
+    for(std::size_t i = 0; i < vertices.size(); ++i)
     {
-        outlines.reserve(vertices.size());
+        vertices[i] = getVertex(static_cast<int>(i));
+    }
+}
 
-        const auto count = vertices.size();
-        for(std::size_t k = 0; k < count; ++k)
-        {
-            const std::size_t kk = k + count; // Ensure in range of vertices with modulo (taking the previous and next vertices)
-            const glm::vec2& a = vertices[(kk - 1) % count].pos;
-            const glm::vec2& b = vertices[kk % count].pos;
-            const glm::vec2& c = vertices[(kk + 1) % count].pos;
+std::span<const std::uint32_t> Shape::getTriangles() const
+{
+    return {};
+}
 
-            const glm::vec2 ab = glm::normalize(b - a);
-            const glm::vec2 bc = glm::normalize(c - b);
+std::vector<Vertex> Shape::getVertices() const
+{
+    std::vector<Vertex> ret(getVerticesCount());
+    writeVertices(ret);
 
-            const glm::vec2 nab {ab.y, -ab.x};
-            const glm::vec2 nbc {bc.y, -bc.x};
+    return ret;
+}
 
-            const float cosx = glm::dot(nab, nbc);
+std::vector<Vertex> Shape::getOutlineVertices() const
+{
+    return getOutlineVertices(m_outlineThickness);
+}
 
-            const float x = std::acos(cosx);
+std::vector<Vertex> Shape::getOutlineVertices(float thickness) const
+{
+    return getOutlineVertices(getVertices(), thickness);
+}
 
-            // Tan=Opp/adj
-            const float y = std::tan(x / 2.0f) * m_outlineThickness;
+std::vector<Vertex> Shape::getOutlineVertices(const std::vector<Vertex>& vertices, float thickness)
+{
+    std::vector<Vertex> outlines;
 
-            Vertex outline;
-            outline.pos = b + nab * m_outlineThickness + ab * y;
+    if(vertices.size() > 2)
+    {
+        std::vector<glm::vec2> outer(vertices.size());
+        Outline::compute(vertices, thickness, outer, &ThreadPool::getGlobal());
 
-            //outline.pos = b + nab * m_outlineThickness;
-            outlines.push_back(outline);
-        }
+        outlines.assign(outer.begin(), outer.end());
     }
 
     return outlines;
 }
 
-GLenum Shape::getUsage() const
+void Shape::needUpdate() const
 {
-    return m_dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW;
+    m_needUpdate = true;
+    m_needFullUpdate = true;
+    m_globalBounds.invalidate();
 }
 
-void Shape::needUpdate()
+void Shape::needUpdate(std::size_t index) const
 {
     m_needUpdate = true;
+    m_dirtyVertices.add(index);
+    m_globalBounds.invalidate();
+}
+
+Rect Shape::getLocalBounds() const
+{
+    if(m_needUpdate)
+    {
+        m_needUpdate = false;
+        update();
+    }
+
+    return m_localBounds;
+}
+
+const Rect& Shape::getGlobalBounds() const
+{
+    return m_globalBounds.get(*this, getLocalBounds());
 }
 
 glm::vec2 Shape::getCenterOfMass(const std::vector<Vertex>& polygon)
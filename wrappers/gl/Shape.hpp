@@ -1,11 +1,16 @@
 #pragma once
 
+#include "Bounds.hpp"
 #include "Drawable.hpp"
 #include "Texture.hpp"
 #include "Transformable.hpp"
 #include "Vertex.hpp"
+#include "VertexBuffer.hpp"
+#include <utility/DirtyRange.hpp>
 #include <glm/vec4.hpp>
 #include <glm/vec2.hpp>
+#include <cstdint>
+#include <span>
 #include <vector>
 
 /// @brief Basic Shape.
@@ -51,10 +56,24 @@ public:
     /// @brief Get if the Shape is dynamic.
     /// @details For optimization.
     /// A Shape is considered dynamic if its parameters are changed often. The default is false.
-    /// It translates to the usage parameter of glBufferData().
+    /// A dynamic Shape has no GPU buffer of its own, its vertices are written in the global StreamBuffer each time
+    /// it is drawn. Otherwise, the vertices are uploaded to its buffers only when they change.
     void setDynamic(bool dynamic);
     bool isDynamic() const;
 
+    /// @brief Set if the GPU buffers have an element buffer. The default is false.
+    /// @details If indexed, the fill and the outline are drawn as indexed triangle lists instead of a fan and a strip,
+    /// like when they are batched by a Renderer. The indices only change with the count of vertices.
+    /// Only used when the Shape is drawn without a Renderer and is not dynamic.
+    void setIndexed(bool indexed);
+    bool isIndexed() const;
+
+    /// @brief Set the layout of the vertices in the GPU buffers.
+    /// @details Full by default. The packed formats use less memory bandwidth, at the cost of the color precision.
+    /// Only used when the Shape is drawn without a Renderer.
+    void setVertexFormat(Vertex::Format format);
+    Vertex::Format getVertexFormat() const;
+
     /// @brief Set the count of vertices of the Shape. Every vertice should be accessible by getVertice(i),
     /// for 0 <= i < getVerticesCount().
     /// @details To be overriden by the child class. No setter is provided to protected from that,
@@ -67,6 +86,18 @@ public:
     /// depending if it is outline or fill color.
     virtual Vertex getVertex(int index) const = 0;
 
+    /// @brief Write all the vertices of the shape at once.
+    /// @details By default, calls getVertex() for each index. Child classes can override it to generate the
+    /// geometry in a single pass, without a virtual call and a copy per vertex.
+    /// @param vertices The destination, of size getVerticesCount().
+    virtual void writeVertices(std::span<Vertex> vertices) const;
+
+    /// @brief Get the triangulation of the fill.
+    /// @details The indices of the vertices, as GL_TRIANGLES. If empty (the default), the fill is drawn as a
+    /// triangle fan, which is only correct for convex shapes.
+    /// Child classes that can be concave override it, the indices are read when the vertices are regenerated.
+    virtual std::span<const std::uint32_t> getTriangles() const;
+
     /// @brief Get all the vertices of the shape.
     /// @details The vertices should form a concave shape, otherwise the shape will not be goodly rendered.
     std::vector<Vertex> getVertices() const;
@@ -76,17 +107,40 @@ public:
     /// If there is not outline, this will return the same as getVertices().
     std::vector<Vertex> getOutlineVertices() const;
 
+    /// @brief Get the outline vertices of the shape, as if the outline thickness was the given thickness.
+    std::vector<Vertex> getOutlineVertices(float thickness) const;
+
+    /// @brief Get the bounding box of the fill and the outline, without the transformation.
+    /// @details By default, computed from the vertices when they are regenerated.
+    /// Child classes can override it if the bounds are known without generating the vertices.
+    virtual Rect getLocalBounds() const;
+
+    /// @brief Get the bounding box in the space of the parent, with the transformation.
+    /// @details Cached until the Shape or its transformation change.
+    const Rect& getGlobalBounds() const;
+
 protected:
-    void needUpdate();
+    /// @brief All the vertices should be regenerated.
+    /// @remarks const so that the geometry can depend on how the Shape is drawn.
+    void needUpdate() const;
+
+    /// @brief Only a single vertex should be regenerated.
+    /// @details If the count of vertices did not change, only the modified vertices will be uploaded.
+    void needUpdate(std::size_t index) const;
 
 private:
     static glm::vec2 getCenterOfMass(const std::vector<Vertex>& polygon);
 
-    GLenum getUsage() const;
+    /// @brief Compute the outer border of the outline of a polygon.
+    static std::vector<Vertex> getOutlineVertices(const std::vector<Vertex>& vertices, float thickness);
 
+    /// @brief Regenerate the vertices on the CPU.
     void update() const;
     void updateOutline() const;
 
+    /// @brief Upload the vertices to the GPU buffers.
+    void upload() const;
+
     const Texture *m_texture{nullptr};
 
     glm::vec4 m_fillColor{1.0f};
@@ -96,13 +150,30 @@ private:
 
     mutable bool m_needUpdate{true}; // True by default, so that if the Shape is never drawn no GPU memory will be used.
     // Also children class constructor may need to be updated
+    mutable bool m_needUpload{true};
+    mutable bool m_needFullUpdate{true}; // If false, only the vertices in m_dirtyVertices need to be regenerated
+
+    mutable DirtyRange m_dirtyVertices; // Vertices to regenerate
+    mutable DirtyRange m_uploadRange; // Fill vertices modified since the last upload
+    mutable DirtyRange m_outlineUploadRange; // Outline vertices modified since the last upload
+
+    mutable std::vector<Vertex> m_vertices; // Fill vertices, drawn as GL_TRIANGLE_FAN
+    mutable std::vector<std::uint32_t> m_triangles; // Fill indices as GL_TRIANGLES, empty if drawn as a fan
+    mutable bool m_needTrianglesUpload{false};
+    mutable std::vector<Vertex> m_outlineVertices; // Outline vertices, drawn as GL_TRIANGLE_STRIP. Empty if no outline.
+    mutable std::vector<Vertex> m_previousOutline; // To find the modified outline vertices, kept to reuse its memory
+    mutable std::vector<glm::vec2> m_outerBorder; // Outer border of the outline, kept to reuse its memory
 
-    GL::VertexArray m_vao; // Fill shape buffer
-    GL::Buffer m_vbo;
+    mutable Rect m_localBounds; // Bounds of m_vertices and m_outlineVertices
+    mutable GlobalBounds m_globalBounds;
 
-    GL::VertexArray m_outlineVao; // Outline shape buffer
-    GL::Buffer m_outlineVbo;
+    mutable VertexBuffer m_buffer; // Fill shape buffer
+    mutable VertexBuffer m_outlineBuffer; // Outline shape buffer
+    mutable std::size_t m_indexedCount{0}; // Count of vertices of the fill indices, zero if not indexed
+    mutable std::size_t m_indexedOutlineCount{0}; // Same for the outline
 
     bool m_dynamic{false};
+    bool m_indexed{false};
+    Vertex::Format m_vertexFormat{Vertex::Format::Full};
 };
 
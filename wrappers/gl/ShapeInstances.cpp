@@ -0,0 +1,240 @@
+#include "ShapeInstances.hpp"
+#include "Circle.hpp"
+#include "Renderer.hpp"
+#include <utility/offset_of.hpp>
+
+void ShapeInstancesBase::draw(RenderStates states) const
+{
+    if(!states.shader)
+    {
+        return;
+    }
+
+    if(m_needGeometryUpdate)
+    {
+        m_needGeometryUpdate = false;
+        updateGeometry();
+    }
+
+    if(m_needInstancesUpdate)
+    {
+        m_needInstancesUpdate = false;
+        updateInstances();
+    }
+
+    if(m_instances.empty() || m_fillCount < 2) // Prevent crash for empty shapes
+    {
+        return;
+    }
+
+    // Not batched, but everything submitted before should be drawn before
+    if(states.renderer)
+    {
+        states.renderer->flush();
+    }
+
+    states.model *= getTransform();
+
+    const auto instanceCount = static_cast<GLsizei>(m_instances.size());
+
+    Shader::bind(states.shader);
+    Texture::bind(getBaseShape().getTexture());
+
+    states.shader->setUniform("u_ModelMatrix", states.model);
+    states.shader->setUniform("u_ViewMatrix", states.view);
+    states.shader->setUniform("u_Color", glm::vec4{1.0f}); // The colors are in the instances
+    states.shader->setUniform("u_Instanced", true);
+
+    if(isSDF())
+    {
+        // Fill and outline at once
+        states.shader->setUniform("u_SDF", true);
+        GL::bindVertexArray(m_sdfVao);
+
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, instanceCount);
+
+        states.shader->setUniform("u_SDF", false);
+        states.shader->setUniform("u_Instanced", false);
+        return;
+    }
+
+    // Draw fill
+    states.shader->setUniform("u_InstancedOutline", false);
+    GL::bindVertexArray(m_vao);
+
+    // Cannot draw triangles with 2 vertices, assume it is a line in this case
+    glDrawArraysInstanced(m_fillCount == 2 ? GL_LINES : GL_TRIANGLE_FAN, 0, m_fillCount, instanceCount);
+
+    // Draw outline if at least one instance has one
+    if(m_outlineCount > 0)
+    {
+        states.shader->setUniform("u_InstancedOutline", true);
+        GL::bindVertexArray(m_outlineVao);
+
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, m_outlineCount, instanceCount);
+
+        states.shader->setUniform("u_InstancedOutline", false);
+    }
+
+    // Not used anywhere else so we should release the flag ourselves
+    states.shader->setUniform("u_Instanced", false);
+}
+
+std::size_t ShapeInstancesBase::add(const Instance& instance)
+{
+    m_instances.push_back(instance);
+    m_needInstancesUpdate = true;
+
+    return m_instances.size() - 1;
+}
+
+void ShapeInstancesBase::clear()
+{
+    m_instances.clear();
+    m_needInstancesUpdate = true;
+}
+
+std::size_t ShapeInstancesBase::getInstanceCount() const
+{
+    return m_instances.size();
+}
+
+ShapeInstancesBase::Instance& ShapeInstancesBase::getInstance(std::size_t index)
+{
+    m_needInstancesUpdate = true;
+    return m_instances[index];
+}
+
+const ShapeInstancesBase::Instance& ShapeInstancesBase::getInstance(std::size_t index) const
+{
+    return m_instances[index];
+}
+
+void ShapeInstancesBase::needGeometryUpdate()
+{
+    m_needGeometryUpdate = true;
+}
+
+void ShapeInstancesBase::instanceAttribPointer()
+{
+    // A mat4 attribute takes 4 locations, one per column
+    for(GLuint i = 0; i < 4; ++i)
+    {
+        const GLuint location = 3 + i;
+        const std::uintptr_t offset = offset_of(&InstanceAttributes::model) + i * sizeof(glm::vec4);
+
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceAttributes), reinterpret_cast<const void*>(offset));
+        glEnableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 1);
+    }
+
+    GL::vertexAttribPointer(7, 4, GL_FLOAT, &InstanceAttributes::color);
+    glVertexAttribDivisor(7, 1);
+
+    GL::vertexAttribPointer(8, 4, GL_FLOAT, &InstanceAttributes::outlineColor);
+    glVertexAttribDivisor(8, 1);
+
+    GL::vertexAttribPointer(9, 1, GL_FLOAT, &InstanceAttributes::outlineThickness);
+    glVertexAttribDivisor(9, 1);
+}
+
+void ShapeInstancesBase::updateGeometry() const
+{
+    const Shape& shape = getBaseShape();
+
+    const std::vector<Vertex> vertices = shape.getVertices();
+    std::vector<Vertex> outlineVertices;
+    std::vector<glm::vec2> outlineOffsets;
+
+    if(vertices.size() > 2)
+    {
+        // The outline is linear with the thickness, so the outer border can be computed in the shader
+        // from the offset for a thickness of 1
+        const std::vector<Vertex> outerVertices = shape.getOutlineVertices(1.0f);
+        const std::size_t size = vertices.size();
+
+        outlineVertices.reserve(2 * size + 2);
+        outlineOffsets.reserve(2 * size + 2);
+
+        // Same layout than Shape: inner and outer border intermixed, and closed
+        for(std::size_t i = 0; i <= size; ++i)
+        {
+            const std::size_t k = i % size;
+
+            // The ouline border have no color (Vertices color is white, and the color of the instance)
+            Vertex inner = vertices[k];
+            inner.color = glm::vec4{1.0f};
+
+            Vertex outer;
+            outer.pos = inner.pos;
+
+            outlineVertices.push_back(inner);
+            outlineOffsets.emplace_back(0.0f);
+
+            outlineVertices.push_back(outer);
+            outlineOffsets.push_back(outerVertices[k].pos - inner.pos);
+        }
+    }
+
+    m_fillCount = static_cast<GLsizei>(vertices.size());
+
+    GL::bindVertexArray(m_vao);
+    GL::bindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    GL::bufferData(GL_ARRAY_BUFFER, vertices, GL_STATIC_DRAW);
+    Vertex::vertexAttribPointer();
+
+    GL::bindBuffer(GL_ARRAY_BUFFER, m_instanceVbo);
+    instanceAttribPointer();
+
+    GL::bindVertexArray(m_outlineVao);
+    GL::bindBuffer(GL_ARRAY_BUFFER, m_outlineVbo);
+    GL::bufferData(GL_ARRAY_BUFFER, outlineVertices, GL_STATIC_DRAW);
+    Vertex::vertexAttribPointer();
+
+    GL::bindBuffer(GL_ARRAY_BUFFER, m_outlineOffsetVbo);
+    GL::bufferData(GL_ARRAY_BUFFER, outlineOffsets, GL_STATIC_DRAW);
+    glVertexAttribPointer(10, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), nullptr);
+    glEnableVertexAttribArray(10);
+
+    GL::bindBuffer(GL_ARRAY_BUFFER, m_instanceVbo);
+    instanceAttribPointer();
+
+    GL::bindVertexArray(m_sdfVao);
+    GL::bindBuffer(GL_ARRAY_BUFFER, m_sdfVbo);
+    const std::span<const Vertex> quad = Circle::getQuadVertices();
+    GL::bufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(quad.size_bytes()), quad.data(), GL_STATIC_DRAW);
+    Vertex::vertexAttribPointer();
+
+    GL::bindBuffer(GL_ARRAY_BUFFER, m_instanceVbo);
+    instanceAttribPointer();
+
+    // The outline count also depends on the instances
+    m_needInstancesUpdate = true;
+}
+
+void ShapeInstancesBase::updateInstances() const
+{
+    std::vector<InstanceAttributes> attributes;
+    attributes.reserve(m_instances.size());
+
+    bool hasOutline = false;
+
+    for(const Instance& instance : m_instances)
+    {
+        attributes.push_back({
+            instance.getTransform(),
+            instance.color,
+            instance.outlineColor,
+            instance.outlineThickness
+        });
+
+        hasOutline = hasOutline || instance.outlineThickness != 0.0f;
+    }
+
+    // + 1 because we need to close the shape
+    m_outlineCount = hasOutline && m_fillCount > 2 ? (m_fillCount + 1) * 2 : 0;
+
+    // Re-specifying the whole buffer orphans the previous storage, it is dynamic because instances change often
+    GL::bindBuffer(GL_ARRAY_BUFFER, m_instanceVbo);
+    GL::bufferData(GL_ARRAY_BUFFER, attributes, GL_DYNAMIC_DRAW);
+}
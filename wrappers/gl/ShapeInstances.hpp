@@ -0,0 +1,143 @@
+#pragma once
+
+#include "Drawable.hpp"
+#include "Transformable.hpp"
+#include "Shape.hpp"
+#include "Vertex.hpp"
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+#include <glm/vec2.hpp>
+#include <utility>
+#include <vector>
+
+/// @brief Many copies of the same Shape drawn with instanced rendering.
+/// @details
+/// The geometry of the shape is uploaded once, and each instance only stores its transform, its fill color and its
+/// outline parameters in an instance attribute buffer. All the instances are drawn with one glDrawArraysInstanced()
+/// call for the fill and one for the outline, instead of two draw calls and two buffers per Shape.
+/// The fill color, outline color and outline thickness of the shape itself are ignored, only its vertices and texture
+/// are used.
+/// If the shape is a Circle in SDF mode, each instance is a single quad and the fill and the outline of all the
+/// instances are drawn with one draw call of 4 vertices per instance.
+/// The ShapeInstances is itself Transformable, the transform is applied to all the instances.
+/// It is not batched with the Renderer, but if there is one in the RenderStates it is flushed before drawing
+/// to keep the order of the draw calls.
+/// @remarks The shader should support the instance attributes at locations 3 to 10, like assets/vert.glsl.
+class ShapeInstancesBase : public Drawable, public Transformable
+{
+public:
+    /// @brief The parameters of a single instance.
+    struct Instance : Transformable
+    {
+        glm::vec4 color{1.0f};
+        glm::vec4 outlineColor{1.0f};
+        float outlineThickness{0.0f}; ///< Zero to disable the outline of this instance.
+    };
+
+    void draw(RenderStates states = {}) const override;
+
+    /// @brief Add an instance.
+    /// @returns The index of the instance.
+    std::size_t add(const Instance& instance);
+
+    void clear();
+
+    std::size_t getInstanceCount() const;
+
+    /// @brief Get an instance to modify it.
+    /// @details The whole instance buffer will be uploaded again at the next draw.
+    Instance& getInstance(std::size_t index);
+    const Instance& getInstance(std::size_t index) const;
+
+protected:
+    /// @brief Get the shape used as the geometry of all the instances.
+    virtual const Shape& getBaseShape() const = 0;
+
+    /// @returns true if the instances should be drawn as SDF quads, like Circle::Mode::SDF.
+    virtual bool isSDF() const = 0;
+
+    /// @brief The geometry of the base shape changed, it should be uploaded again at the next draw.
+    void needGeometryUpdate();
+
+private:
+    /// @brief Layout of the instance attribute buffer.
+    struct InstanceAttributes
+    {
+        glm::mat4 model;
+        glm::vec4 color;
+        glm::vec4 outlineColor;
+        float outlineThickness;
+    };
+
+    /// @brief Setup the instance attributes for the currently bound VAO and instance buffer.
+    static void instanceAttribPointer();
+
+    void updateGeometry() const;
+    void updateInstances() const;
+
+    std::vector<Instance> m_instances;
+
+    mutable bool m_needGeometryUpdate{true};
+    mutable bool m_needInstancesUpdate{true};
+    mutable GLsizei m_fillCount{0};
+    mutable GLsizei m_outlineCount{0}; ///< Zero if no instance has an outline.
+
+    GL::VertexArray m_vao; // Fill geometry
+    GL::Buffer m_vbo;
+
+    GL::VertexArray m_outlineVao; // Outline geometry
+    GL::Buffer m_outlineVbo;
+    GL::Buffer m_outlineOffsetVbo; // Outline offsets for a thickness of 1, location 10
+
+    GL::VertexArray m_sdfVao; // Quad geometry, for SDF instances
+    GL::Buffer m_sdfVbo;
+
+    GL::Buffer m_instanceVbo; // Shared by both VAOs
+};
+
+/// @brief Instanced rendering of a specific Shape type, for example ShapeInstances<Circle>.
+template<typename T>
+class ShapeInstances : public ShapeInstancesBase
+{
+public:
+    /// @param args The arguments to construct the base shape.
+    template<typename... Args>
+    explicit ShapeInstances(Args&&... args)
+        : m_shape(std::forward<Args>(args)...)
+    {
+    }
+
+    /// @brief Get the base shape to modify its geometry.
+    /// @details The geometry will be uploaded again at the next draw.
+    T& getShape()
+    {
+        needGeometryUpdate();
+        return m_shape;
+    }
+
+    const T& getShape() const
+    {
+        return m_shape;
+    }
+
+protected:
+    const Shape& getBaseShape() const override
+    {
+        return m_shape;
+    }
+
+    bool isSDF() const override
+    {
+        if constexpr(requires { m_shape.getMode(); })
+        {
+            return m_shape.getMode() == T::Mode::SDF;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+private:
+    T m_shape;
+};
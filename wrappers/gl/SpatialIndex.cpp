@@ -0,0 +1,250 @@
+#include "SpatialIndex.hpp"
+#include "Bounds.hpp"
+#include <algorithm>
+#include <cmath>
+
+SpatialGrid::SpatialGrid(float cellSize)
+    : m_cellSize(cellSize)
+{
+}
+
+SpatialGrid::Id SpatialGrid::insert(const Rect& bounds)
+{
+    Id id;
+
+    if(m_free.empty())
+    {
+        id = static_cast<Id>(m_entries.size());
+        m_entries.emplace_back();
+    }
+    else
+    {
+        id = m_free.back();
+        m_free.pop_back();
+    }
+
+    Entry& entry = m_entries[id];
+    entry.bounds = bounds;
+    entry.used = true;
+
+    link(id);
+
+    return id;
+}
+
+void SpatialGrid::update(Id id, const Rect& bounds)
+{
+    Entry& entry = m_entries[id];
+    entry.bounds = bounds;
+
+    const glm::ivec2 minCell = getCell(bounds.bottomLeft());
+    const glm::ivec2 maxCell = getCell(bounds.topRight());
+
+    // Usually a moving rect stays in the same cells
+    if(!entry.large && minCell == entry.minCell && maxCell == entry.maxCell)
+    {
+        return;
+    }
+
+    unlink(id);
+    link(id);
+}
+
+void SpatialGrid::remove(Id id)
+{
+    unlink(id);
+
+    m_entries[id].used = false;
+    m_free.push_back(id);
+}
+
+void SpatialGrid::clear()
+{
+    m_entries.clear();
+    m_free.clear();
+    m_cells.clear();
+    m_large.clear();
+}
+
+const Rect& SpatialGrid::getBounds(Id id) const
+{
+    return m_entries[id].bounds;
+}
+
+std::size_t SpatialGrid::getSize() const
+{
+    return m_entries.size() - m_free.size();
+}
+
+float SpatialGrid::getCellSize() const
+{
+    return m_cellSize;
+}
+
+std::size_t SpatialGrid::getCellCount() const
+{
+    return m_cells.size();
+}
+
+void SpatialGrid::query(const Rect& area, std::vector<Id>& result) const
+{
+    const glm::ivec2 minCell = getCell(area.bottomLeft());
+    const glm::ivec2 maxCell = getCell(area.topRight());
+
+    // A rect in many cells is found in each of them, it is only reported in the first cell of the intersection
+    // of its cells with the queried cells, so there is no need to remember which rects were already found
+    auto visit = [&](int x, int y, const std::vector<Id>& ids) {
+        for(Id id : ids)
+        {
+            const Entry& entry = m_entries[id];
+
+            if(x == std::max(entry.minCell.x, minCell.x) && y == std::max(entry.minCell.y, minCell.y) &&
+               Bounds::intersects(entry.bounds, area))
+            {
+                result.push_back(id);
+            }
+        }
+    };
+
+    const glm::dvec2 areaSize = glm::dvec2{maxCell - minCell} + 1.0;
+    const double areaCells = areaSize.x * areaSize.y;
+
+    if(areaCells > static_cast<double>(m_cells.size()))
+    {
+        // Large area, like a zoomed-out view: faster to visit all the non-empty cells
+        for(const auto& [key, ids] : m_cells)
+        {
+            const auto x = static_cast<int>(static_cast<std::int32_t>(key >> 32));
+            const auto y = static_cast<int>(static_cast<std::int32_t>(key & 0xffffffff));
+
+            if(x >= minCell.x && x <= maxCell.x && y >= minCell.y && y <= maxCell.y)
+            {
+                visit(x, y, ids);
+            }
+        }
+    }
+    else
+    {
+        for(int y = minCell.y; y <= maxCell.y; ++y)
+        {
+            for(int x = minCell.x; x <= maxCell.x; ++x)
+            {
+                if(auto it = m_cells.find(getKey(x, y)); it != m_cells.end())
+                {
+                    visit(x, y, it->second);
+                }
+            }
+        }
+    }
+
+    for(Id id : m_large)
+    {
+        if(Bounds::intersects(m_entries[id].bounds, area))
+        {
+            result.push_back(id);
+        }
+    }
+}
+
+void SpatialGrid::query(const glm::vec2& point, std::vector<Id>& result) const
+{
+    const Rect area{glm::vec2{0.0f}, point};
+    const glm::ivec2 cell = getCell(point);
+
+    if(auto it = m_cells.find(getKey(cell.x, cell.y)); it != m_cells.end())
+    {
+        for(Id id : it->second)
+        {
+            if(Bounds::intersects(m_entries[id].bounds, area))
+            {
+                result.push_back(id);
+            }
+        }
+    }
+
+    for(Id id : m_large)
+    {
+        if(Bounds::intersects(m_entries[id].bounds, area))
+        {
+            result.push_back(id);
+        }
+    }
+}
+
+void SpatialGrid::queryView(const glm::mat4& view, std::vector<Id>& result) const
+{
+    // The clip space square, in the space of the rects
+    const Rect clipSpace{{2.0f, 2.0f}};
+    query(Bounds::transform(clipSpace, glm::inverse(view)), result);
+}
+
+glm::vec2 SpatialGrid::fromClipSpace(const glm::mat4& view, const glm::vec2& point)
+{
+    return glm::vec2{glm::inverse(view) * glm::vec4{point, 0.0f, 1.0f}};
+}
+
+std::uint64_t SpatialGrid::getKey(int x, int y)
+{
+    return static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32 | static_cast<std::uint32_t>(y);
+}
+
+glm::ivec2 SpatialGrid::getCell(const glm::vec2& position) const
+{
+    return glm::ivec2{glm::floor(position / m_cellSize)};
+}
+
+void SpatialGrid::link(Id id)
+{
+    Entry& entry = m_entries[id];
+    entry.minCell = getCell(entry.bounds.bottomLeft());
+    entry.maxCell = getCell(entry.bounds.topRight());
+
+    const glm::ivec2 cells = entry.maxCell - entry.minCell + 1;
+    entry.large = static_cast<long long>(cells.x) * cells.y > maxCellsPerRect;
+
+    if(entry.large)
+    {
+        m_large.push_back(id);
+        return;
+    }
+
+    for(int y = entry.minCell.y; y <= entry.maxCell.y; ++y)
+    {
+        for(int x = entry.minCell.x; x <= entry.maxCell.x; ++x)
+        {
+            m_cells[getKey(x, y)].push_back(id);
+        }
+    }
+}
+
+void SpatialGrid::unlink(Id id)
+{
+    const Entry& entry = m_entries[id];
+
+    // The order in a cell does not matter, so the id is replaced by the last one
+    auto erase = [id](std::vector<Id>& ids) {
+        auto it = std::find(ids.begin(), ids.end(), id);
+        *it = ids.back();
+        ids.pop_back();
+    };
+
+    if(entry.large)
+    {
+        erase(m_large);
+        return;
+    }
+
+    for(int y = entry.minCell.y; y <= entry.maxCell.y; ++y)
+    {
+        for(int x = entry.minCell.x; x <= entry.maxCell.x; ++x)
+        {
+            auto it = m_cells.find(getKey(x, y));
+            erase(it->second);
+
+            if(it->second.empty())
+            {
+                m_cells.erase(it);
+            }
+        }
+    }
+}
@@ -0,0 +1,210 @@
+#pragma once
+
+#include "Transformable.hpp"
+#include <utility/Rect.hpp>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/// @brief Hashed uniform grid of axis-aligned rects, to find the rects in an area without testing all of them.
+/// @details
+/// The plane is split in square cells of a fixed size, and each rect is registered in all the cells it overlaps.
+/// Only the non-empty cells are stored, in a hash map, so the world does not need to be bounded.
+/// A query only visits the cells overlapping the queried area, so its cost depends on the count of rects near the
+/// area, not on the total count. Moving a rect without leaving its cells only updates its bounds.
+/// The rects much larger than a cell are kept in a separate list, tested by each query, so that they do not fill
+/// thousands of cells.
+/// The cell size should be about the size of the common rects: much smaller and the rects are in many cells,
+/// much larger and each cell contains many rects.
+class SpatialGrid
+{
+public:
+    using Id = std::uint32_t;
+
+    /// @param cellSize The side of a cell, in the units of the rects.
+    explicit SpatialGrid(float cellSize = 1.0f);
+
+    /// @returns The id of the rect, the ids of the removed rects are reused.
+    Id insert(const Rect& bounds);
+
+    /// @brief Set the new bounds of a rect, after it moved or changed its size.
+    void update(Id id, const Rect& bounds);
+
+    void remove(Id id);
+
+    void clear();
+
+    const Rect& getBounds(Id id) const;
+
+    /// @returns The count of rects.
+    std::size_t getSize() const;
+
+    float getCellSize() const;
+
+    /// @returns The count of non-empty cells.
+    std::size_t getCellCount() const;
+
+    /// @brief Append the ids of the rects intersecting an area, each id only once, in no particular order.
+    void query(const Rect& area, std::vector<Id>& result) const;
+
+    /// @brief Append the ids of the rects containing a point.
+    void query(const glm::vec2& point, std::vector<Id>& result) const;
+
+    /// @brief Append the ids of the rects visible with a view, like Bounds::isVisible().
+    /// @param view The transformation to clip space, like RenderStates::view * RenderStates::model.
+    void queryView(const glm::mat4& view, std::vector<Id>& result) const;
+
+    /// @brief Convert a point in clip space to the space of the rects, like UnifiedInput::getMouseInClipSpace().
+    static glm::vec2 fromClipSpace(const glm::mat4& view, const glm::vec2& point);
+
+private:
+    /// @brief Over this count of cells, a rect is in the large rects list instead of the cells.
+    static constexpr int maxCellsPerRect = 64;
+
+    struct Entry
+    {
+        Rect bounds;
+        glm::ivec2 minCell{0}; ///< The cells overlapped by the rect, inclusive.
+        glm::ivec2 maxCell{-1};
+        bool large{false};
+        bool used{false};
+    };
+
+    static std::uint64_t getKey(int x, int y);
+
+    glm::ivec2 getCell(const glm::vec2& position) const;
+
+    void link(Id id);
+    void unlink(Id id);
+
+    float m_cellSize;
+    std::vector<Entry> m_entries;
+    std::vector<Id> m_free;
+    std::unordered_map<std::uint64_t, std::vector<Id>> m_cells;
+    std::vector<Id> m_large;
+};
+
+/// @brief Spatial index of drawables, updated incrementally when they are moved.
+/// @details
+/// The index listens to the Transformable of each drawable: a setter only marks the drawable dirty, and
+/// refresh() reads again the global bounds of the dirty drawables. So moving a few drawables among millions
+/// costs only the moved ones.
+/// The drawables are removed automatically when they are destroyed.
+/// @tparam T A Transformable with getGlobalBounds(), like Shape, Text, RichText or VertexArray.
+/// @remarks A drawable can only be in one index at a time, it is its Transformable listener.
+template<typename T>
+class SpatialIndex : private Transformable::Listener
+{
+public:
+    using Id = SpatialGrid::Id;
+
+    explicit SpatialIndex(float cellSize = 1.0f)
+        : m_grid(cellSize)
+    {
+    }
+
+    ~SpatialIndex() override
+    {
+        clear();
+    }
+
+    SpatialIndex(const SpatialIndex&) = delete;
+    SpatialIndex& operator=(const SpatialIndex&) = delete;
+
+    Id insert(T& object)
+    {
+        const Id id = m_grid.insert(object.getGlobalBounds());
+
+        if(id >= m_objects.size())
+        {
+            m_objects.resize(id + 1, nullptr);
+            m_dirty.resize(id + 1, false);
+        }
+
+        m_objects[id] = &object;
+        object.setListener(this, id);
+
+        return id;
+    }
+
+    void remove(Id id)
+    {
+        m_objects[id]->setListener(nullptr);
+        m_objects[id] = nullptr;
+        m_grid.remove(id);
+    }
+
+    void clear()
+    {
+        for(T *object : m_objects)
+        {
+            if(object)
+            {
+                object->setListener(nullptr);
+            }
+        }
+
+        m_objects.clear();
+        m_dirty.clear();
+        m_dirtyIds.clear();
+        m_grid.clear();
+    }
+
+    T& get(Id id) const
+    {
+        return *m_objects[id];
+    }
+
+    /// @brief Mark a drawable as modified, when its local bounds change.
+    /// @details Not needed when its transform changes, it is notified by the Transformable.
+    void markDirty(Id id)
+    {
+        if(!m_dirty[id])
+        {
+            m_dirty[id] = true;
+            m_dirtyIds.push_back(id);
+        }
+    }
+
+    /// @brief Update the bounds of the modified drawables. Should be called before the queries.
+    void refresh()
+    {
+        for(Id id : m_dirtyIds)
+        {
+            // It may have been removed after being marked
+            if(m_objects[id])
+            {
+                m_grid.update(id, m_objects[id]->getGlobalBounds());
+            }
+
+            m_dirty[id] = false;
+        }
+
+        m_dirtyIds.clear();
+    }
+
+    /// @brief The grid, for the queries.
+    const SpatialGrid& getGrid() const
+    {
+        return m_grid;
+    }
+
+private:
+    void onTransformChanged(std::uint32_t key) override
+    {
+        markDirty(key);
+    }
+
+    void onTransformDestroyed(std::uint32_t key) override
+    {
+        // The object is already partially destroyed, only forget it
+        m_objects[key] = nullptr;
+        m_grid.remove(key);
+    }
+
+    SpatialGrid m_grid;
+    std::vector<T*> m_objects; ///< By id, nullptr if the id is free.
+    std::vector<bool> m_dirty; ///< By id, if it is in m_dirtyIds.
+    std::vector<Id> m_dirtyIds;
+};
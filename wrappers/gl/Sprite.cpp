@@ -1,5 +1,7 @@
 #include "Sprite.hpp"
 #include <utility/Rect.hpp>
+#include <algorithm>
+#include <iterator>
 
 Sprite::Sprite(const glm::vec2& size)
     : m_size(size)
@@ -11,26 +13,28 @@ Sprite::Sprite(const glm::vec2& size)
     texRect.translate(m_size / 2.0f); // Sprite bottom-left is negative but uv bottom-left should be 0.
     texRect.size = m_size;
 
-    Vertex bottomRight;
-    bottomRight.pos = posRect.bottomRight();
-    bottomRight.uv = texRect.bottomRight();
+    m_vertices[0].pos = posRect.bottomRight();
+    m_vertices[1].pos = posRect.topRight();
+    m_vertices[2].pos = posRect.topLeft();
+    m_vertices[3].pos = posRect.bottomLeft();
 
-    Vertex topRight;
-    topRight.pos = posRect.topRight();
-    topRight.uv = texRect.topRight();
+    setTextureRect(texRect);
+}
 
-    Vertex topLeft;
-    topLeft.pos = posRect.topLeft();
-    topLeft.uv = texRect.topLeft();
+void Sprite::setTextureRect(const Rect& rect)
+{
+    m_vertices[0].uv = rect.bottomRight();
+    m_vertices[1].uv = rect.topRight();
+    m_vertices[2].uv = rect.topLeft();
+    m_vertices[3].uv = rect.bottomLeft();
 
-    Vertex bottomLeft;
-    bottomLeft.pos = posRect.bottomLeft();
-    bottomLeft.uv = texRect.bottomLeft();
+    m_textureRect = rect;
+    needUpdate();
+}
 
-    m_vertices[0] = bottomRight;
-    m_vertices[1] = topRight;
-    m_vertices[2] = topLeft;
-    m_vertices[3] = bottomLeft;
+const Rect& Sprite::getTextureRect() const
+{
+    return m_textureRect;
 }
 
 size_t Sprite::getVerticesCount() const
@@ -42,3 +46,8 @@ Vertex Sprite::getVertex(int index) const
 {
     return m_vertices[index];
 }
+
+void Sprite::writeVertices(std::span<Vertex> vertices) const
+{
+    std::copy(std::begin(m_vertices), std::end(m_vertices), vertices.begin());
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Shape.hpp"
+#include <utility/Rect.hpp>
 
 /// @brief A sprite is simply a rectangular shape.
 /// @details The rectangle is centered in (0, 0) and has a side length of 1.
@@ -11,9 +12,16 @@ public:
 
     size_t getVerticesCount() const override;
     Vertex getVertex(int index) const override;
+    void writeVertices(std::span<Vertex> vertices) const override;
+
+    /// @brief Set the area of the texture to display, in UV coordinates.
+    /// @details By default, the whole texture when the size is 1.
+    void setTextureRect(const Rect& rect);
+    const Rect& getTextureRect() const;
 
 private:
     glm::vec2 m_size{1.0f};
+    Rect m_textureRect;
     Vertex m_vertices[4];
 };
 
@@ -0,0 +1,236 @@
+#include "StreamBuffer.hpp"
+#include "Indices.hpp"
+#include <utility/Exception.hpp>
+#include <utility/Str.hpp>
+
+StreamBuffer::StreamBuffer(std::size_t regionSize, std::size_t regionCount)
+    : m_regionSize(regionSize), m_regionCount(regionCount), m_fences(regionCount, nullptr)
+{
+    const auto size = static_cast<GLsizeiptr>(m_regionSize * m_regionCount);
+
+    m_persistent = GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+
+    GL::bindBuffer(GL_ARRAY_BUFFER, m_buffer);
+
+    if(m_persistent)
+    {
+        // Coherent, so the writes are visible to the next draw calls without flushing
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+        glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags);
+        m_mapped = static_cast<unsigned char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags));
+
+        if(!m_mapped)
+        {
+            throw Exception("Failed to map the stream buffer");
+        }
+    }
+    else
+    {
+        GL::bufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    }
+
+    for(std::size_t i = 0; i < formatCount; ++i)
+    {
+        GL::bindVertexArray(m_vaos[i]);
+        Vertex::vertexAttribPointer(static_cast<Vertex::Format>(i));
+
+        // The element buffer binding is part of the VAO state
+        GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_buffer);
+    }
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    for(GLsync fence : m_fences)
+    {
+        if(fence)
+        {
+            glDeleteSync(fence);
+        }
+    }
+
+    if(m_mapped)
+    {
+        GL::bindBuffer(GL_ARRAY_BUFFER, m_buffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+}
+
+StreamBuffer& StreamBuffer::getGlobal()
+{
+    static StreamBuffer buffer;
+    return buffer;
+}
+
+bool StreamBuffer::isPersistent() const
+{
+    return m_persistent;
+}
+
+std::size_t StreamBuffer::getMaxVertexCount(Vertex::Format format) const
+{
+    // Same limit as allocate()
+    return m_regionSize / Vertex::getSize(format) - 1;
+}
+
+template<typename Pack>
+std::size_t StreamBuffer::write(std::size_t size, std::size_t stride, const Pack& pack)
+{
+    const std::size_t offset = allocate(size, stride);
+
+    if(m_persistent)
+    {
+        pack(m_mapped + offset, offset);
+    }
+    else
+    {
+        // The range was never written since the last orphaning, so there is nothing to synchronize with
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+
+        GL::bindBuffer(GL_ARRAY_BUFFER, m_buffer);
+        void *destination = glMapBufferRange(GL_ARRAY_BUFFER, static_cast<GLintptr>(offset),
+                                             static_cast<GLsizeiptr>(size), flags);
+
+        if(!destination)
+        {
+            throw Exception("Failed to map the stream buffer");
+        }
+
+        pack(static_cast<unsigned char*>(destination), offset);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+
+    GL::countUpload(size);
+
+    return offset;
+}
+
+GLint StreamBuffer::write(std::span<const Vertex> vertices, Vertex::Format format)
+{
+    if(vertices.empty())
+    {
+        return 0;
+    }
+
+    const std::size_t stride = Vertex::getSize(format);
+
+    const std::size_t offset = write(vertices.size() * stride, stride, [&](unsigned char *destination, std::size_t) {
+        Vertex::pack(vertices, format, destination);
+    });
+
+    return static_cast<GLint>(offset / stride);
+}
+
+StreamBuffer::IndexedGeometry StreamBuffer::write(std::span<const Vertex> vertices, Vertex::Format format,
+                                                  std::span<const std::uint32_t> indices, GLenum type)
+{
+    if(vertices.empty())
+    {
+        return {0, 0};
+    }
+
+    const std::size_t stride = Vertex::getSize(format);
+    const std::size_t indexStride = Indices::getSize(type);
+    const std::size_t vertexBytes = vertices.size() * stride;
+
+    IndexedGeometry geometry{};
+
+    // The indices are aligned to their stride after the vertices, the padding is always smaller than it
+    const std::size_t size = vertexBytes + indexStride - 1 + indices.size() * indexStride;
+
+    write(size, stride, [&](unsigned char *destination, std::size_t offset) {
+        const std::size_t indexOffset = (offset + vertexBytes + indexStride - 1) / indexStride * indexStride;
+
+        Vertex::pack(vertices, format, destination);
+
+        if(!indices.empty())
+        {
+            Indices::pack(indices, type, destination + (indexOffset - offset));
+        }
+
+        geometry = {static_cast<GLint>(offset / stride), indexOffset};
+    });
+
+    return geometry;
+}
+
+void StreamBuffer::bindVertexArray(Vertex::Format format) const
+{
+    GL::bindVertexArray(m_vaos[static_cast<std::size_t>(format)]);
+}
+
+std::size_t StreamBuffer::allocate(std::size_t size, std::size_t stride)
+{
+    // The start of a region may not be aligned to the stride
+    if(size + stride > m_regionSize)
+    {
+        throw Exception(Str{} << "Cannot stream " << size << " bytes, the regions are " << m_regionSize << " bytes");
+    }
+
+    auto align = [stride](std::size_t offset) {
+        return (offset + stride - 1) / stride * stride;
+    };
+
+    std::size_t offset = align(m_head);
+
+    if(offset + size > (m_region + 1) * m_regionSize)
+    {
+        // All the draw calls reading the region were issued, the fence is signaled when they are finished
+        if(m_persistent)
+        {
+            m_fences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+
+        enterRegion((m_region + 1) % m_regionCount);
+        offset = align(m_head);
+    }
+
+    m_head = offset + size;
+
+    return offset;
+}
+
+void StreamBuffer::enterRegion(std::size_t region)
+{
+    m_region = region;
+    m_head = region * m_regionSize;
+
+    if(m_persistent)
+    {
+        GLsync& fence = m_fences[region];
+
+        if(fence)
+        {
+            // Usually already signaled, since the GPU had the time to draw the other regions
+            GLbitfield flags = 0;
+
+            while(true)
+            {
+                const GLenum result = glClientWaitSync(fence, flags, 1'000'000); // 1ms
+
+                if(result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED)
+                {
+                    break;
+                }
+
+                if(result == GL_WAIT_FAILED)
+                {
+                    throw Exception("Failed to wait for the stream buffer fence");
+                }
+
+                // Make sure the fence will be signaled
+                flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+            }
+
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    else if(region == 0)
+    {
+        // Orphan the storage, the draw calls still reading it keep the previous one
+        GL::bindBuffer(GL_ARRAY_BUFFER, m_buffer);
+        GL::bufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_regionSize * m_regionCount), nullptr, GL_STREAM_DRAW);
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "GL.hpp"
+#include "Vertex.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// @brief Ring buffer for the vertices that change every frame.
+/// @details
+/// The vertices are written directly into GPU memory, then drawn with the index of their first vertex.
+/// The buffer is split in regions. When a region is full, the writes continue in the next one:
+/// - If GL_ARB_buffer_storage is available, the whole buffer is mapped once with GL_MAP_PERSISTENT_BIT.
+///   A fence is inserted when leaving a region, and waited before writing again in it, so the CPU never overwrites
+///   vertices the GPU has not read yet.
+/// - Otherwise, each write maps its range with GL_MAP_UNSYNCHRONIZED_BIT, and the buffer is orphaned when the ring
+///   wraps around, so the driver never has to synchronize.
+/// There is one VAO per vertex format reading the buffer. The buffer is also their element buffer, so indices can
+/// be streamed in the same buffer and drawn with glDrawElementsBaseVertex().
+/// @remarks Only one draw call should use the vertices, they are overwritten a few regions later.
+class StreamBuffer
+{
+public:
+    /// @brief Location of an indexed geometry written in the buffer.
+    struct IndexedGeometry
+    {
+        GLint first; ///< Index of the first vertex, the base vertex of glDrawElementsBaseVertex().
+        std::uintptr_t indices; ///< Offset of the first index in bytes, the indices parameter of glDrawElements().
+    };
+
+    /// @param regionSize The size of a region in bytes, the maximum size of a single write.
+    /// @param regionCount The count of regions. The GPU can read regionCount - 1 regions while the CPU writes.
+    explicit StreamBuffer(std::size_t regionSize = 1 << 22, std::size_t regionCount = 4);
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    /// @brief Get the stream buffer shared by all the dynamic drawables.
+    static StreamBuffer& getGlobal();
+
+    /// @returns true if the buffer is persistently mapped, false if it uses orphaning.
+    bool isPersistent() const;
+
+    /// @returns The maximum count of vertices of a single write, a region minus the alignment of its start.
+    std::size_t getMaxVertexCount(Vertex::Format format) const;
+
+    /// @brief Write vertices in the buffer.
+    /// @returns The index of the first vertex, to be used as the first parameter of glDrawArrays().
+    /// @throws If the vertices do not fit in a region.
+    GLint write(std::span<const Vertex> vertices, Vertex::Format format);
+
+    /// @brief Write vertices and their indices in the buffer, in a single allocation.
+    /// @details The indices follow the vertices in the same region. With two separate writes, the second one could
+    /// enter a new region, which orphans the buffer or fences the previous region before the draw call reading the
+    /// vertices is issued.
+    /// @param type The type of the indices in the buffer, see Indices::getType().
+    /// @throws If the vertices and indices do not fit in a region.
+    IndexedGeometry write(std::span<const Vertex> vertices, Vertex::Format format,
+                          std::span<const std::uint32_t> indices, GLenum type);
+
+    /// @brief Bind the VAO reading the buffer with a format.
+    void bindVertexArray(Vertex::Format format) const;
+
+private:
+    static constexpr std::size_t formatCount = 3;
+
+    /// @returns The offset where to write, aligned to the stride so that it is an index of vertex.
+    std::size_t allocate(std::size_t size, std::size_t stride);
+
+    /// @brief Allocate size bytes, and call pack(destination, offset) to write them.
+    /// @returns The offset of the bytes in the buffer.
+    template<typename Pack>
+    std::size_t write(std::size_t size, std::size_t stride, const Pack& pack);
+
+    void enterRegion(std::size_t region);
+
+    GL::Buffer m_buffer;
+    GL::VertexArray m_vaos[formatCount];
+
+    std::size_t m_regionSize;
+    std::size_t m_regionCount;
+
+    std::size_t m_region{0}; ///< The region being written.
+    std::size_t m_head{0}; ///< Offset of the next write.
+
+    bool m_persistent{false};
+    unsigned char *m_mapped{nullptr}; ///< The whole buffer, if persistent.
+    std::vector<GLsync> m_fences; ///< Fence of each region, null if the region is not used by the GPU.
+};
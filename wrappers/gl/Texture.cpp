@@ -1,9 +1,21 @@
 #include "Texture.hpp"
+#include "TextureLoader.hpp"
+#include "TextureRegistry.hpp"
 #include <wrappers/SDL.hpp>
 #include <utility/IO.hpp>
+#include <utility/Guard.hpp>
+#include <glm/common.hpp>
+#include <algorithm>
+#include <iostream>
 
 Texture::Texture()
 {
+    TextureRegistry::getGlobal().add(*this);
+}
+
+Texture::~Texture()
+{
+    TextureRegistry::getGlobal().remove(*this);
 }
 
 void Texture::load1x1White()
@@ -12,24 +24,43 @@ void Texture::load1x1White()
         0xff, 0xff, 0xff, 0xff // RGBA Opaque white 1x1
     };
 
-    glBindTexture(GL_TEXTURE_2D, m_texture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
-    glGenerateMipmap(GL_TEXTURE_2D);
+    create({1, 1}, GL_RGBA, pixels);
+    generateMipmap();
+    m_source.clear();
 }
 
-void Texture::load(const std::filesystem::path& path)
+void Texture::loadPlaceholder()
+{
+    const std::size_t previous = getMemorySize();
+
+    // Frees the previous storage, the name is only used again once the texture is created or replaced
+    m_texture = GL::Texture{};
+    m_size = {1, 1};
+    m_format = GL_RGBA;
+    m_mipLevels = 1;
+    m_resident = true;
+    m_placeholder = true;
+    m_source.clear();
+
+    TextureRegistry::getGlobal().resize(previous, getMemorySize());
+}
+
+Texture::Image Texture::decode(const std::filesystem::path& path)
 {
-    SDL_Surface *image = IMG_Load(path.string().c_str());
-    if(!image)
+    SDL_Surface *surface = IMG_Load(path.string().c_str());
+    if(!surface)
     {
         throw FileNotFoundException(path);
     }
 
-    load(image);
-    SDL_FreeSurface(image);
+    WhenLeaveScope {
+        SDL_FreeSurface(surface);
+    };
+
+    return decode(surface);
 }
 
-void Texture::load(SDL_Surface *surface)
+Texture::Image Texture::decode(SDL_Surface *surface)
 {
     // Note that the format could be any format, we need to convert to a format we know to tell the format to OpenGL
     // We convert to RGBA unsigned char
@@ -40,14 +71,16 @@ void Texture::load(SDL_Surface *surface)
     }
 
     SDL_Surface *converted = SDL_ConvertSurface(surface, format, 0);
+    SDL_FreeFormat(format);
+
     if(!converted)
     {
         throw SDL::Exception("Failed to convert surface");
     }
 
-    SDL_FreeFormat(format);
-
-    SDL::flip_vertically(converted);
+    WhenLeaveScope {
+        SDL_FreeSurface(converted);
+    };
 
     // Neeeded if we want to directly access the pixels
     if(SDL_LockSurface(converted) != 0)
@@ -55,32 +88,230 @@ void Texture::load(SDL_Surface *surface)
         throw SDL::Exception("Failed to lock texture");
     }
 
-    glBindTexture(GL_TEXTURE_2D, m_texture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, converted->w, converted->h, 0, GL_RGBA, GL_UNSIGNED_BYTE, converted->pixels);
-    glGenerateMipmap(GL_TEXTURE_2D);
+    Image image;
+    image.size = {converted->w, converted->h};
+
+    const std::size_t rowSize = static_cast<std::size_t>(converted->w) * 4;
+    image.pixels.resize(rowSize * static_cast<std::size_t>(converted->h));
+
+    // The rows are copied in reverse order, OpenGL starts from the bottom. The pitch of the surface can be larger
+    // than the row.
+    const auto *source = static_cast<const unsigned char*>(converted->pixels);
+    for(int y = 0; y < converted->h; ++y)
+    {
+        std::copy_n(source + static_cast<std::size_t>(y) * converted->pitch, rowSize,
+                    image.pixels.begin() + static_cast<std::ptrdiff_t>((converted->h - 1 - y) * rowSize));
+    }
 
     SDL_UnlockSurface(converted);
+
+    return image;
+}
+
+void Texture::load(const std::filesystem::path& path)
+{
+    load(decode(path));
+    m_source = path;
+}
+
+void Texture::load(SDL_Surface *surface)
+{
+    load(decode(surface));
+}
+
+void Texture::load(const Texture::Image& image)
+{
+    create(image.size, GL_RGBA, image.pixels.data());
+    generateMipmap();
+    m_source.clear();
+}
+
+void Texture::create(const glm::ivec2& size, GLenum format, const void *pixels)
+{
+    // Before binding, an evicted texture is overwritten and not restored
+    setStorage(size, format, 1);
+
+    bind();
+    glTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(format), size.x, size.y, 0, format, GL_UNSIGNED_BYTE, pixels);
+}
+
+void Texture::generateMipmap()
+{
+    bind();
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    // Each level halves the size, down to 1x1
+    int levels = 1;
+    for(int side = std::max(m_size.x, m_size.y); side > 1; side /= 2)
+    {
+        levels++;
+    }
+
+    setStorage(m_size, m_format, levels);
+}
+
+void Texture::replace(Texture& other)
+{
+    swapStorage(other);
+
+    if(m_filter)
+    {
+        setFilter(*m_filter);
+    }
+}
+
+void Texture::setSource(const std::filesystem::path& path)
+{
+    m_source = path;
+}
+
+const std::filesystem::path& Texture::getSource() const
+{
+    return m_source;
+}
+
+void Texture::setStorage(const glm::ivec2& size, GLenum format, int mipLevels)
+{
+    const std::size_t previous = getMemorySize();
+
+    m_size = size;
+    m_format = format;
+    m_mipLevels = mipLevels;
+    m_resident = true;
+    m_placeholder = false;
+
+    TextureRegistry::getGlobal().resize(previous, getMemorySize());
+}
+
+void Texture::evict()
+{
+    const std::size_t previous = getMemorySize();
+
+    // Deleting the texture is the only way to be sure the driver frees the memory
+    m_texture = GL::Texture{};
+    m_resident = false;
+
+    TextureRegistry::getGlobal().resize(previous, 0);
+}
+
+void Texture::restore() const
+{
+    // The cached dimensions are kept until the image is uploaded, the drawables using it keep their layout
+    if(TextureLoader *loader = TextureRegistry::getGlobal().getLoader())
+    {
+        m_resident = true;
+        m_placeholder = true;
+        loader->restore(*this);
+        return;
+    }
+
+    Image decoded;
+
+    try
+    {
+        decoded = decode(m_source);
+    }
+    catch(const std::exception& e)
+    {
+        // Called while drawing, the frame should not be interrupted
+        std::cerr << "Failed to restore the texture " << m_source << ", replaced by a placeholder: " << e.what()
+                  << std::endl;
+
+        failRestore();
+        return;
+    }
+
+    Texture image;
+    image.create(decoded.size, GL_RGBA, decoded.pixels.data());
+
+    if(m_mipLevels > 1)
+    {
+        image.generateMipmap();
+    }
+
+    restore(image);
+}
+
+void Texture::restore(Texture& image) const
+{
+    swapStorage(image);
+
+    // The texture was recreated by evict(), so it has the default parameters of OpenGL
+    if(m_filter)
+    {
+        GL::bindTexture(GL_TEXTURE_2D, m_texture);
+        applyFilter(*m_filter);
+    }
+}
+
+void Texture::failRestore() const
+{
+    m_source.clear();
+    m_resident = true;
+    m_placeholder = true;
+}
+
+void Texture::cancelRestore() const
+{
+    // A placeholder uses no memory, there is nothing to account for
+    m_resident = false;
+    m_placeholder = false;
+}
+
+void Texture::swapStorage(Texture& other) const
+{
+    const std::size_t previous = getMemorySize();
+    const std::size_t otherPrevious = other.getMemorySize();
+
+    swap(m_texture, other.m_texture);
+    std::swap(m_size, other.m_size);
+    std::swap(m_format, other.m_format);
+    std::swap(m_mipLevels, other.m_mipLevels);
+    std::swap(m_resident, other.m_resident);
+    std::swap(m_placeholder, other.m_placeholder);
+
+    TextureRegistry& registry = TextureRegistry::getGlobal();
+    registry.resize(previous, getMemorySize());
+    registry.resize(otherPrevious, other.getMemorySize());
 }
 
 void Texture::bind(const Texture *texture)
 {
+    // Textures are always used with the unit 0, the sampler u_Texture
+    GL::activeTexture(GL_TEXTURE0);
+
     if(texture)
     {
-        glBindTexture(GL_TEXTURE_2D, texture->m_texture);
+        texture->m_lastBind = TextureRegistry::getGlobal().tick();
+
+        if(!texture->m_resident)
+        {
+            texture->restore();
+        }
+    }
+
+    if(texture && !texture->m_placeholder)
+    {
+        GL::bindTexture(GL_TEXTURE_2D, texture->m_texture);
     }
     else
     {
-        static Texture defaultTex;
-        static bool initialized = false;
+        GL::bindTexture(GL_TEXTURE_2D, getDefault().m_texture);
+    }
+}
 
-        if(!initialized)
-        {
-            initialized = true;
-            defaultTex.load1x1White();
-        }
+const Texture& Texture::getDefault()
+{
+    static Texture defaultTex;
+    static bool initialized = false;
 
-        glBindTexture(GL_TEXTURE_2D, defaultTex.m_texture);
+    if(!initialized)
+    {
+        initialized = true;
+        defaultTex.load1x1White();
     }
+
+    return defaultTex;
 }
 
 void Texture::bind() const
@@ -90,10 +321,24 @@ void Texture::bind() const
 
 unsigned int Texture::getID() const
 {
-    return m_texture.id;
+    return m_placeholder ? getDefault().m_texture.id : m_texture.id;
 }
 
 void Texture::setFilter(Texture::Filter filter)
+{
+    m_filter = filter;
+
+    // Applied when it is restored or replaced, the storage of a placeholder is shared
+    if(!m_resident || m_placeholder)
+    {
+        return;
+    }
+
+    bind();
+    applyFilter(filter);
+}
+
+void Texture::applyFilter(Texture::Filter filter)
 {
     int gl_filter;
 
@@ -108,19 +353,63 @@ void Texture::setFilter(Texture::Filter filter)
             break;
     }
 
-    bind();
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, gl_filter);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, gl_filter);
 }
 
 glm::vec2 Texture::getSize() const
 {
-    int miplevel = 0;
-    int w, h;
+    return glm::vec2(m_size);
+}
 
-    bind();
-    glGetTexLevelParameteriv(GL_TEXTURE_2D, miplevel, GL_TEXTURE_WIDTH, &w);
-    glGetTexLevelParameteriv(GL_TEXTURE_2D, miplevel, GL_TEXTURE_HEIGHT, &h);
+GLenum Texture::getFormat() const
+{
+    return m_format;
+}
 
-    return {w, h};
+int Texture::getMipLevels() const
+{
+    return m_mipLevels;
+}
+
+std::size_t Texture::getMemorySize() const
+{
+    if(!m_resident)
+    {
+        return 0;
+    }
+
+    // The storage is the one of the default texture, accounted once by it
+    if(m_placeholder)
+    {
+        return 0;
+    }
+
+    const std::size_t bytesPerPixel = m_format == GL_RED ? 1 : 4;
+
+    std::size_t bytes = 0;
+    glm::ivec2 size = m_size;
+
+    for(int level = 0; level < m_mipLevels; ++level)
+    {
+        bytes += static_cast<std::size_t>(size.x) * static_cast<std::size_t>(size.y) * bytesPerPixel;
+        size = glm::max(size / 2, glm::ivec2{1});
+    }
+
+    return bytes;
+}
+
+bool Texture::isResident() const
+{
+    return m_resident;
+}
+
+bool Texture::isPlaceholder() const
+{
+    return m_placeholder;
+}
+
+std::uint64_t Texture::getLastBind() const
+{
+    return m_lastBind;
 }
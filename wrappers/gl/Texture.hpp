@@ -3,29 +3,102 @@
 #include <wrappers/gl/GL.hpp>
 #include <SDL2/SDL_surface.h>
 #include <glm/vec2.hpp>
+#include <cstdint>
 #include <filesystem>
+#include <optional>
+#include <vector>
 
+/// @brief 2D texture, with its dimensions cached on upload so they never have to be queried from OpenGL.
+/// @details The textures are registered in the TextureRegistry by their address, so they are neither copyable nor
+/// movable. A texture loaded from a file can be evicted by the registry, it is reloaded when it is bound again.
 class Texture
 {
 public:
+    /// @brief Pixels in the layout of the textures: RGBA with 8 bits per channel, rows from the bottom to the top.
+    struct Image
+    {
+        glm::ivec2 size{0};
+        std::vector<unsigned char> pixels; ///< Tightly packed rows, 4 * size.x bytes each.
+    };
+
     Texture();
+    ~Texture();
+
+    Texture(const Texture&) = delete;
+    Texture& operator=(const Texture&) = delete;
+
+    /// @brief Decode an image file and convert it to the layout of the textures.
+    /// @details Does not use OpenGL, so it can be called from any thread.
+    /// @throws FileNotFoundException If the image cannot be loaded.
+    static Image decode(const std::filesystem::path& path);
+
+    /// @brief Convert a surface to the layout of the textures.
+    /// @details Does not use OpenGL, so it can be called from any thread.
+    static Image decode(SDL_Surface *surface);
 
     /// @brief Set the texture as 1x1 opaque white
     void load1x1White();
 
+    /// @brief Display the default 1x1 opaque white texture, until the texture is loaded or replaced.
+    /// @details The storage is shared by all the placeholders, so they use no memory of their own.
+    void loadPlaceholder();
+
     /// @brief Load from an image file on the disk.
+    /// @details The file becomes the source of the texture.
     void load(const std::filesystem::path& path);
 
     /// @brief Load from a SDL_Surface.
     /// @param surface The surface from which to load. Not const because the surface will save copy informations.
     void load(SDL_Surface *surface);
 
+    void load(const Image& image);
+
+    /// @brief Allocate the storage of the texture, without mipmaps.
+    /// @param format The format of the texture and of the pixels, with 8 bits per channel.
+    /// @param pixels The pixels to upload, or nullptr to leave them uninitialized.
+    /// @remarks No buffer should be bound to GL_PIXEL_UNPACK_BUFFER if pixels is nullptr.
+    void create(const glm::ivec2& size, GLenum format = GL_RGBA, const void *pixels = nullptr);
+
+    /// @brief Generate the mipmaps from the level 0.
+    void generateMipmap();
+
+    /// @brief Take the OpenGL texture of other and its dimensions, the previous one is given to other.
+    /// @details The filter set on this texture is applied to the new one. The address of this texture does not
+    /// change, so the drawables referencing it will display the new content.
+    void replace(Texture& other);
+
+    /// @brief Set the file from which the texture can be reloaded after an eviction.
+    /// @details Set by load(path), and cleared by the other loads. A texture without source is never evicted.
+    void setSource(const std::filesystem::path& path);
+    const std::filesystem::path& getSource() const;
+
     static void bind(const Texture* texture);
     void bind() const;
 
     /// @brief Get the size of the texture in pixel.
+    /// @remarks Cached, it is still known when the texture is evicted.
     glm::vec2 getSize() const;
 
+    /// @returns The format given to OpenGL, GL_RGBA or GL_RED.
+    GLenum getFormat() const;
+
+    /// @returns The count of mipmap levels, including the level 0.
+    int getMipLevels() const;
+
+    /// @brief Estimate the GPU memory used by the texture, from its dimensions.
+    /// @returns The size in bytes, 0 if it is evicted.
+    std::size_t getMemorySize() const;
+
+    /// @returns false if the texture has been evicted and is not bound since.
+    bool isResident() const;
+
+    /// @returns true if the texture displays the shared placeholder, see loadPlaceholder().
+    bool isPlaceholder() const;
+
+    /// @returns The value of the clock of the registry when the texture was bound for the last time.
+    std::uint64_t getLastBind() const;
+
+    /// @returns The OpenGL name of the texture, the one of the shared placeholder if it is one.
     unsigned int getID() const;
 
     enum Filter {
@@ -37,8 +110,55 @@ public:
     void setFilter(Filter filter);
 
 private:
+    friend class TextureRegistry;
+    friend class TextureLoader;
+
+    /// @brief Update the dimensions, and the memory accounted by the registry.
+    void setStorage(const glm::ivec2& size, GLenum format, int mipLevels);
+
+    /// @brief Free the OpenGL storage, the dimensions are kept.
+    void evict();
+
+    /// @brief Reload the texture from its source after an eviction.
+    /// @details Const because it is done when the texture is bound. If the TextureRegistry has a loader, the texture
+    /// displays the placeholder until the loader uploads the image. Otherwise the image is decoded and uploaded right
+    /// away, which stalls the frame.
+    void restore() const;
+
+    /// @brief Take the storage of image, decoded from the source. Its dimensions replace the cached ones, the file may
+    /// have changed since the eviction.
+    void restore(Texture& image) const;
+
+    /// @brief The source cannot be read anymore: the texture stays a placeholder, with the cached dimensions so the
+    /// drawables keep their layout, and loses its source so it is neither read nor evicted again.
+    void failRestore() const;
+
+    /// @brief The loader stopped restoring the texture, it is evicted again and restored at its next bind.
+    void cancelRestore() const;
+
+    /// @brief Exchange the storage and the dimensions, and account for them in the registry.
+    void swapStorage(Texture& other) const;
+
+    /// @brief Set the filter on the bound texture.
+    static void applyFilter(Filter filter);
+
+    /// @brief Get the 1x1 opaque white texture bound instead of nullptr and of the placeholders.
+    static const Texture& getDefault();
+
     static std::weak_ptr<const Texture> m_defaultTexture;
 
-    GL::Texture m_texture;
+    /// @brief Mutable, replaced when the texture is restored by bind().
+    mutable GL::Texture m_texture;
+    std::optional<Filter> m_filter; ///< Set with setFilter(), the default of OpenGL otherwise
+
+    // Mutable, refreshed from the decoded image when the texture is restored by bind()
+    mutable glm::ivec2 m_size{0};
+    mutable GLenum m_format{GL_RGBA};
+    mutable int m_mipLevels{0};
+
+    mutable std::filesystem::path m_source; ///< Mutable, cleared when it fails to be restored
+    mutable bool m_resident{true};
+    mutable bool m_placeholder{false}; ///< The default texture is bound instead, the size is not the one of the storage
+    mutable std::uint64_t m_lastBind{0};
 };
 
@@ -0,0 +1,266 @@
+#include "TextureLoader.hpp"
+#include "TextureRegistry.hpp"
+#include <utility/Exception.hpp>
+#include <utility/Guard.hpp>
+#include <algorithm>
+#include <cstring>
+
+TextureLoader::TextureLoader(unsigned int workerCount, std::size_t budget)
+    : m_budget(budget),
+      m_pool(workerCount)
+{
+}
+
+TextureLoader::~TextureLoader()
+{
+    TextureRegistry& registry = TextureRegistry::getGlobal();
+
+    if(registry.getLoader() == this)
+    {
+        registry.setLoader(nullptr);
+    }
+
+    std::lock_guard lock(m_mutex);
+    m_stop = true;
+}
+
+std::shared_ptr<Texture> TextureLoader::load(const std::filesystem::path& path)
+{
+    auto texture = std::make_shared<Texture>();
+    texture->loadPlaceholder();
+
+    Decoded decoded;
+    decoded.target = texture;
+    decoded.path = path;
+    submit(std::move(decoded));
+
+    return texture;
+}
+
+void TextureLoader::restore(const Texture& texture)
+{
+    const std::uint64_t ticket = ++m_restoreCount;
+    m_restoring[&texture] = ticket;
+
+    Decoded decoded;
+    decoded.restored = &texture;
+    decoded.ticket = ticket;
+    decoded.path = texture.getSource();
+    submit(std::move(decoded));
+}
+
+void TextureLoader::cancelRestore(const Texture& texture)
+{
+    m_restoring.erase(&texture);
+}
+
+void TextureLoader::cancelRestores()
+{
+    for(const auto& [texture, ticket] : m_restoring)
+    {
+        texture->cancelRestore();
+    }
+
+    // The results still decoding or uploading are dropped
+    m_restoring.clear();
+}
+
+bool TextureLoader::isRestoring(const Texture *texture, std::uint64_t ticket) const
+{
+    auto it = m_restoring.find(texture);
+    return it != m_restoring.end() && it->second == ticket;
+}
+
+void TextureLoader::submit(Decoded decoded)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_decoding++;
+    }
+
+    m_pool.submit([this, decoded = std::move(decoded)]() mutable {
+        {
+            std::lock_guard lock(m_mutex);
+
+            // Nobody will upload it. A cancelled restoration is only known by the thread owning the context.
+            if(m_stop || (!decoded.restored && decoded.target.expired()))
+            {
+                m_decoding--;
+                return;
+            }
+        }
+
+        try
+        {
+            decoded.image = Texture::decode(decoded.path);
+        }
+        catch(...)
+        {
+            decoded.error = std::current_exception();
+        }
+
+        std::lock_guard lock(m_mutex);
+        m_decoded.push_back(std::move(decoded));
+        m_decoding--;
+    });
+}
+
+void TextureLoader::update()
+{
+    std::vector<Decoded> decoded;
+
+    {
+        std::lock_guard lock(m_mutex);
+        decoded.swap(m_decoded);
+    }
+
+    std::exception_ptr error;
+
+    for(Decoded& result : decoded)
+    {
+        // The texture was destroyed, or its restoration was cancelled
+        if(result.restored && !isRestoring(result.restored, result.ticket))
+        {
+            continue;
+        }
+
+        if(result.error || result.image.size.x <= 0 || result.image.size.y <= 0)
+        {
+            if(result.restored)
+            {
+                result.restored->failRestore();
+                m_restoring.erase(result.restored);
+            }
+
+            // The first one is thrown once the others are queued, so they are not lost
+            if(result.error && !error)
+            {
+                error = result.error;
+            }
+        }
+        else if(result.restored)
+        {
+            m_uploads.push_back({nullptr, result.restored, result.ticket, std::move(result.path),
+                                 std::move(result.image)});
+        }
+        else if(auto target = result.target.lock())
+        {
+            m_uploads.push_back({std::move(target), nullptr, 0, std::move(result.path), std::move(result.image)});
+        }
+    }
+
+    std::size_t budget = m_budget;
+
+    while(!m_uploads.empty() && budget > 0)
+    {
+        Upload& upload = m_uploads.front();
+
+        // Dropped if the texture was released while it was loading, or if its restoration was cancelled
+        const bool wanted = upload.restored ? isRestoring(upload.restored, upload.ticket)
+                                            : upload.target.use_count() > 1;
+
+        if(wanted)
+        {
+            budget -= std::min(budget, uploadRows(upload, budget));
+
+            if(upload.uploadedRows < upload.image.size.y)
+            {
+                continue;
+            }
+
+            if(upload.restored)
+            {
+                // Like before the eviction
+                if(upload.restored->getMipLevels() > 1)
+                {
+                    upload.staging->generateMipmap();
+                }
+
+                upload.restored->restore(*upload.staging);
+                m_restoring.erase(upload.restored);
+            }
+            else
+            {
+                upload.staging->generateMipmap();
+                upload.target->replace(*upload.staging);
+                upload.target->setSource(upload.path);
+            }
+        }
+
+        m_uploads.pop_front();
+    }
+
+    if(error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+std::size_t TextureLoader::uploadRows(TextureLoader::Upload& upload, std::size_t budget)
+{
+    const glm::ivec2 size = upload.image.size;
+    const std::size_t rowSize = static_cast<std::size_t>(size.x) * 4;
+
+    // The pixel buffer is not bound yet, otherwise nullptr would be an offset in it
+    if(upload.uploadedRows == 0)
+    {
+        upload.staging->create(size);
+    }
+
+    const int rows = std::clamp(static_cast<int>(budget / std::max<std::size_t>(rowSize, 1)), 1,
+                                size.y - upload.uploadedRows);
+    const std::size_t bytes = rowSize * static_cast<std::size_t>(rows);
+
+    // Orphaned at each slice, the driver gives new memory if the previous slice is still being read
+    GL::bindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pixelBuffer);
+
+    // Other uploads read the pixels from client memory, even if this one throws
+    WhenLeaveScope {
+        GL::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    };
+
+    GL::bufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_DRAW);
+
+    void *destination = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes),
+                                         GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+
+    if(!destination)
+    {
+        throw Exception("Failed to map the pixel buffer");
+    }
+
+    const std::size_t first = rowSize * static_cast<std::size_t>(upload.uploadedRows);
+    std::memcpy(destination, upload.image.pixels.data() + first, bytes);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    GL::countUpload(bytes);
+
+    // The rows are tightly packed, 4 bytes per pixel is always aligned
+    upload.staging->bind();
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, upload.uploadedRows, size.x, rows, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+    upload.uploadedRows += rows;
+
+    // Not needed anymore, the texture is the only copy
+    if(upload.uploadedRows == size.y)
+    {
+        upload.image.pixels = {};
+    }
+
+    return bytes;
+}
+
+void TextureLoader::setBudget(std::size_t budget)
+{
+    m_budget = budget;
+}
+
+std::size_t TextureLoader::getBudget() const
+{
+    return m_budget;
+}
+
+std::size_t TextureLoader::getPendingCount() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_decoding + m_decoded.size() + m_uploads.size();
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "Texture.hpp"
+#include <utility/ThreadPool.hpp>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/// @brief Load textures without blocking the thread owning the OpenGL context.
+/// @details
+/// The images are decoded and converted on worker threads. update(), called once per frame, uploads them through
+/// a pixel buffer object, a limited count of bytes per call, so loading many images spreads over several frames.
+/// load() returns the texture immediately, as a 1x1 opaque white placeholder sharing the storage of the default
+/// texture (see Texture::loadPlaceholder()). It is replaced by the image once all its rows are uploaded, at the same
+/// address, so it can be given to drawables right away. The file becomes the source of the texture, so the
+/// TextureRegistry can evict it.
+/// Given to TextureRegistry::setLoader(), it also restores the evicted textures when they are bound again, the same
+/// way: they display the placeholder until their image is uploaded, instead of stalling the frame.
+/// @remarks The workers are not the ones of the global pool: decoding takes long, and would delay the
+/// parallelFor() calls of the frame, which wait for their ranges queued behind.
+class TextureLoader
+{
+public:
+    /// @param workerCount The count of threads decoding the images.
+    /// @param budget The maximum count of bytes uploaded by update(), at least one row is always uploaded.
+    explicit TextureLoader(unsigned int workerCount = 2, std::size_t budget = 1 << 22);
+
+    /// @brief Wait for the images being decoded, the ones not started yet are dropped.
+    /// @details If this is the loader of the TextureRegistry, it is unset.
+    ~TextureLoader();
+
+    TextureLoader(const TextureLoader&) = delete;
+    TextureLoader& operator=(const TextureLoader&) = delete;
+
+    /// @brief Start to load an image file.
+    /// @remarks Must be called on the thread owning the OpenGL context, the placeholder is created here.
+    /// @returns The texture, which displays the placeholder until the image is uploaded. If it is released before,
+    /// the image is not uploaded.
+    std::shared_ptr<Texture> load(const std::filesystem::path& path);
+
+    /// @brief Upload the decoded images, at most the budget in bytes.
+    /// @remarks Must be called on the thread owning the OpenGL context.
+    /// @throws The exception thrown while decoding an image, FileNotFoundException for example. The other images
+    /// continue to load at the next call. A texture which failed to be restored stays a placeholder.
+    void update();
+
+    void setBudget(std::size_t budget);
+    std::size_t getBudget() const;
+
+    /// @returns The count of textures still displaying their placeholder, decoded or not.
+    std::size_t getPendingCount() const;
+
+private:
+    friend class Texture;
+    friend class TextureRegistry;
+
+    /// @brief Result of a worker.
+    struct Decoded
+    {
+        std::weak_ptr<Texture> target{};
+        const Texture *restored{nullptr}; ///< The texture to restore, instead of a target.
+        std::uint64_t ticket{0}; ///< Identifies the restoration, see m_restoring.
+        std::filesystem::path path{};
+        Texture::Image image{};
+        std::exception_ptr error{};
+    };
+
+    /// @brief Image being uploaded into a staging texture, swapped with the target when complete.
+    struct Upload
+    {
+        std::shared_ptr<Texture> target;
+        const Texture *restored;
+        std::uint64_t ticket;
+        std::filesystem::path path;
+        Texture::Image image;
+        std::unique_ptr<Texture> staging{std::make_unique<Texture>()}; ///< Textures are not movable
+        int uploadedRows{0};
+    };
+
+    /// @brief Reload an evicted texture from its source, called by Texture::bind().
+    /// @details The texture is a placeholder until its image is uploaded.
+    void restore(const Texture& texture);
+
+    /// @brief Stop restoring a texture, because it is destroyed.
+    void cancelRestore(const Texture& texture);
+
+    /// @brief Stop restoring all the textures, they are evicted again. Called when this stops being the loader of
+    /// the TextureRegistry, the textures are restored by the next one.
+    void cancelRestores();
+
+    /// @returns false if the texture of the restoration was destroyed, or restored by another one since.
+    bool isRestoring(const Texture *texture, std::uint64_t ticket) const;
+
+    /// @brief Decode an image on a worker.
+    void submit(Decoded decoded);
+
+    /// @brief Upload the next rows of the upload.
+    /// @returns The count of bytes uploaded.
+    std::size_t uploadRows(Upload& upload, std::size_t budget);
+
+    std::size_t m_budget;
+    GL::Buffer m_pixelBuffer;
+    std::deque<Upload> m_uploads;
+
+    /// @brief The ticket of the last restoration of each texture being restored. A ticket is unique, so the result
+    /// of a cancelled restoration is dropped even if another texture was created at the same address since.
+    std::unordered_map<const Texture*, std::uint64_t> m_restoring;
+    std::uint64_t m_restoreCount{0};
+
+    mutable std::mutex m_mutex;
+    std::vector<Decoded> m_decoded;
+    std::size_t m_decoding{0}; ///< Count of images submitted to the workers, not decoded yet
+    bool m_stop{false}; ///< Set by the destructor, the workers skip the remaining images
+
+    ThreadPool m_pool; ///< Last, so the workers are joined before the rest is destroyed
+};
@@ -0,0 +1,126 @@
+#include "TextureRegistry.hpp"
+#include "Texture.hpp"
+#include "TextureLoader.hpp"
+#include <algorithm>
+#include <vector>
+
+TextureRegistry& TextureRegistry::getGlobal()
+{
+    static TextureRegistry registry;
+    return registry;
+}
+
+void TextureRegistry::setBudget(std::size_t bytes)
+{
+    m_budget = bytes;
+}
+
+std::size_t TextureRegistry::getBudget() const
+{
+    return m_budget;
+}
+
+std::size_t TextureRegistry::getMemorySize() const
+{
+    return m_memorySize;
+}
+
+std::size_t TextureRegistry::getTextureCount() const
+{
+    return m_textures.size();
+}
+
+std::size_t TextureRegistry::getEvictionCount() const
+{
+    return m_evictionCount;
+}
+
+TextureRegistry::Stats TextureRegistry::getStats() const
+{
+    return {m_memorySize, m_textures.size(), m_evictionCount};
+}
+
+void TextureRegistry::setLoader(TextureLoader *loader)
+{
+    if(m_loader && m_loader != loader)
+    {
+        m_loader->cancelRestores();
+    }
+
+    m_loader = loader;
+}
+
+TextureLoader* TextureRegistry::getLoader() const
+{
+    return m_loader;
+}
+
+std::size_t TextureRegistry::trim()
+{
+    const std::uint64_t lastTrim = m_lastTrim;
+    m_lastTrim = m_clock;
+
+    if(m_memorySize <= m_budget)
+    {
+        return 0;
+    }
+
+    std::vector<Texture*> candidates;
+
+    for(Texture *texture : m_textures)
+    {
+        // A placeholder being restored uses no memory
+        if(texture->isResident() && !texture->isPlaceholder() && !texture->getSource().empty()
+           && texture->getLastBind() <= lastTrim)
+        {
+            candidates.push_back(texture);
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const Texture *a, const Texture *b) {
+        return a->getLastBind() < b->getLastBind();
+    });
+
+    std::size_t evicted = 0;
+
+    for(Texture *texture : candidates)
+    {
+        if(m_memorySize <= m_budget)
+        {
+            break;
+        }
+
+        texture->evict();
+        evicted++;
+    }
+
+    m_evictionCount += evicted;
+
+    return evicted;
+}
+
+void TextureRegistry::add(Texture& texture)
+{
+    m_textures.insert(&texture);
+}
+
+void TextureRegistry::remove(Texture& texture)
+{
+    if(m_loader)
+    {
+        m_loader->cancelRestore(texture);
+    }
+
+    m_memorySize -= texture.getMemorySize();
+    m_textures.erase(&texture);
+}
+
+void TextureRegistry::resize(std::size_t previous, std::size_t current)
+{
+    m_memorySize = m_memorySize - previous + current;
+}
+
+std::uint64_t TextureRegistry::tick()
+{
+    return ++m_clock;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+
+class Texture;
+class TextureLoader;
+
+/// @brief Account for the GPU memory used by all the textures, and evict them when it exceeds a budget.
+/// @details
+/// Every Texture registers itself at construction. The memory is estimated from the dimensions cached by the
+/// textures, OpenGL is never queried. trim(), called between two frames, evicts the least recently bound textures
+/// until the memory fits in the budget. Only the textures with a source file can be evicted: they are reloaded the
+/// next time they are bound. With a loader (see setLoader()), they display the placeholder until the loader uploads
+/// their image, possibly a few frames later. Without, the image is decoded and uploaded synchronously by
+/// Texture::bind(), which stalls the frame being drawn.
+/// @remarks Like the textures themselves, it must only be used on the thread owning the OpenGL context.
+class TextureRegistry
+{
+public:
+    /// @brief Copy of the counters, to be read by another thread.
+    struct Stats
+    {
+        std::size_t memorySize{0};
+        std::size_t textureCount{0};
+        std::size_t evictionCount{0};
+    };
+
+    TextureRegistry() = default;
+
+    TextureRegistry(const TextureRegistry&) = delete;
+    TextureRegistry& operator=(const TextureRegistry&) = delete;
+
+    /// @brief Get the registry of all the textures.
+    static TextureRegistry& getGlobal();
+
+    /// @param bytes The memory above which trim() evicts textures.
+    void setBudget(std::size_t bytes);
+    std::size_t getBudget() const;
+
+    /// @returns The estimated memory of the resident textures, in bytes.
+    std::size_t getMemorySize() const;
+
+    std::size_t getTextureCount() const;
+
+    /// @returns The count of textures evicted since the creation of the registry.
+    std::size_t getEvictionCount() const;
+
+    Stats getStats() const;
+
+    /// @brief Set the loader restoring the evicted textures, nullptr to restore them synchronously.
+    /// @details The textures the previous loader was restoring are evicted again, and restored by the new one at their
+    /// next bind. The loader unsets itself when it is destroyed.
+    void setLoader(TextureLoader *loader);
+    TextureLoader* getLoader() const;
+
+    /// @brief Evict the least recently bound textures until the memory fits in the budget.
+    /// @details The textures bound since the previous call are kept, even above the budget, otherwise they would be
+    /// reloaded every frame.
+    /// @returns The count of evicted textures.
+    std::size_t trim();
+
+private:
+    friend class Texture;
+
+    void add(Texture& texture);
+    void remove(Texture& texture);
+
+    /// @brief Account for a change of the memory of a texture.
+    void resize(std::size_t previous, std::size_t current);
+
+    /// @returns The next value of the clock, to stamp a bound texture.
+    std::uint64_t tick();
+
+    std::unordered_set<Texture*> m_textures;
+    TextureLoader *m_loader{nullptr};
+    std::size_t m_budget{std::size_t{512} << 20};
+    std::size_t m_memorySize{0};
+    std::size_t m_evictionCount{0};
+
+    std::uint64_t m_clock{0};
+    std::uint64_t m_lastTrim{0}; ///< Value of the clock at the previous trim()
+};
@@ -0,0 +1,321 @@
+#include "TransformStore.hpp"
+#include <utility/ThreadPool.hpp>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define TRANSFORM_STORE_SSE2
+    #include <emmintrin.h>
+#endif
+
+namespace
+{
+    // Range reduction to [-pi/4, pi/4]: x = q * pi/2 + r.
+    // pi/2 is split in three parts so that q * part is exact for the first ones (Cody-Waite)
+    constexpr float twoOverPi = 0.636619772367581343f;
+    constexpr float halfPi1 = 1.5703125f;
+    constexpr float halfPi2 = 4.837512969970703125e-4f;
+    constexpr float halfPi3 = 7.54978995489188216e-8f;
+
+    // Minimax polynomials on [-pi/4, pi/4] (from Cephes sinf/cosf)
+    constexpr float sin1 = -1.6666654611e-1f;
+    constexpr float sin2 = 8.3321608736e-3f;
+    constexpr float sin3 = -1.9515295891e-4f;
+
+    constexpr float cos1 = 4.166664568298827e-2f;
+    constexpr float cos2 = -1.388731625493765e-3f;
+    constexpr float cos3 = 2.443315711809948e-5f;
+
+    void sincos(float x, float& s, float& c)
+    {
+        const float q = std::nearbyint(x * twoOverPi);
+        const float r = ((x - q * halfPi1) - q * halfPi2) - q * halfPi3;
+        const float r2 = r * r;
+
+        const float ps = r + r * r2 * (sin1 + r2 * (sin2 + r2 * sin3));
+        const float pc = 1.0f - 0.5f * r2 + r2 * r2 * (cos1 + r2 * (cos2 + r2 * cos3));
+
+        // sin(x + q * pi/2) is sin(x), cos(x), -sin(x), -cos(x) depending on the quadrant
+        switch(static_cast<int>(q) & 3)
+        {
+            case 0: s = ps; c = pc; break;
+            case 1: s = pc; c = -ps; break;
+            case 2: s = -ps; c = -pc; break;
+            default: s = -pc; c = ps; break;
+        }
+    }
+
+#ifdef TRANSFORM_STORE_SSE2
+    /// @brief Same as the scalar sincos(), for 4 values.
+    void sincos(__m128 x, __m128& s, __m128& c)
+    {
+        // Rounded to nearest
+        const __m128i qi = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(twoOverPi)));
+        const __m128 q = _mm_cvtepi32_ps(qi);
+
+        __m128 r = _mm_sub_ps(x, _mm_mul_ps(q, _mm_set1_ps(halfPi1)));
+        r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(halfPi2)));
+        r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(halfPi3)));
+
+        const __m128 r2 = _mm_mul_ps(r, r);
+
+        __m128 ps = _mm_add_ps(_mm_set1_ps(sin2), _mm_mul_ps(r2, _mm_set1_ps(sin3)));
+        ps = _mm_add_ps(_mm_set1_ps(sin1), _mm_mul_ps(r2, ps));
+        ps = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, r2), ps));
+
+        __m128 pc = _mm_add_ps(_mm_set1_ps(cos2), _mm_mul_ps(r2, _mm_set1_ps(cos3)));
+        pc = _mm_add_ps(_mm_set1_ps(cos1), _mm_mul_ps(r2, pc));
+        pc = _mm_mul_ps(_mm_mul_ps(r2, r2), pc);
+        pc = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), r2)), pc);
+
+        // Odd quadrants swap sin and cos
+        const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(qi, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+        s = _mm_or_ps(_mm_and_ps(swap, pc), _mm_andnot_ps(swap, ps));
+        c = _mm_or_ps(_mm_and_ps(swap, ps), _mm_andnot_ps(swap, pc));
+
+        // Sign bit: sin is negated in quadrants 2 and 3, cos in quadrants 1 and 2
+        const __m128i sinSign = _mm_slli_epi32(_mm_and_si128(qi, _mm_set1_epi32(2)), 30);
+        const __m128i cosSign = _mm_slli_epi32(_mm_and_si128(_mm_add_epi32(qi, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30);
+        s = _mm_xor_ps(s, _mm_castsi128_ps(sinSign));
+        c = _mm_xor_ps(c, _mm_castsi128_ps(cosSign));
+    }
+
+    /// @brief Load 4 vec2 and split them in x and y.
+    void loadVec2(const glm::vec2 *v, __m128& x, __m128& y)
+    {
+        const __m128 a = _mm_loadu_ps(&v[0].x);
+        const __m128 b = _mm_loadu_ps(&v[2].x);
+
+        x = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        y = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    }
+#endif
+}
+
+TransformStore& TransformStore::getGlobal()
+{
+    static TransformStore store;
+    return store;
+}
+
+TransformStore::Index TransformStore::allocate()
+{
+    if(m_free.empty())
+    {
+        // Grow by a whole block so that the arrays size is always a multiple of the block size
+        const std::size_t size = getCapacity();
+        const std::size_t newSize = size + blockSize;
+
+        m_position.resize(newSize, glm::vec2{0.0f});
+        m_rotation.resize(newSize, 0.0f);
+        m_scale.resize(newSize, glm::vec2{1.0f});
+        m_origin.resize(newSize, glm::vec2{0.0f});
+
+        m_m00.resize(newSize, 1.0f);
+        m_m01.resize(newSize, 0.0f);
+        m_m10.resize(newSize, 0.0f);
+        m_m11.resize(newSize, 1.0f);
+        m_tx.resize(newSize, 0.0f);
+        m_ty.resize(newSize, 0.0f);
+
+        m_dirty.resize(newSize, 0);
+
+        // Allocated in increasing order
+        for(std::size_t i = newSize; i > size; --i)
+        {
+            m_free.push_back(static_cast<Index>(i - 1));
+        }
+    }
+
+    const Index index = m_free.back();
+    m_free.pop_back();
+
+    // Identity
+    m_position[index] = glm::vec2{0.0f};
+    m_rotation[index] = 0.0f;
+    m_scale[index] = glm::vec2{1.0f};
+    m_origin[index] = glm::vec2{0.0f};
+    markDirty(index);
+
+    return index;
+}
+
+void TransformStore::release(Index index)
+{
+    m_free.push_back(index);
+}
+
+std::size_t TransformStore::getCapacity() const
+{
+    return m_rotation.size();
+}
+
+const glm::vec2& TransformStore::getPosition(Index index) const
+{
+    return m_position[index];
+}
+
+void TransformStore::setPosition(Index index, const glm::vec2& position)
+{
+    m_position[index] = position;
+    markDirty(index);
+}
+
+float TransformStore::getRotation(Index index) const
+{
+    return m_rotation[index];
+}
+
+void TransformStore::setRotation(Index index, float rotation)
+{
+    m_rotation[index] = rotation;
+    markDirty(index);
+}
+
+const glm::vec2& TransformStore::getScale(Index index) const
+{
+    return m_scale[index];
+}
+
+void TransformStore::setScale(Index index, const glm::vec2& scale)
+{
+    m_scale[index] = scale;
+    markDirty(index);
+}
+
+const glm::vec2& TransformStore::getOrigin(Index index) const
+{
+    return m_origin[index];
+}
+
+void TransformStore::setOrigin(Index index, const glm::vec2& origin)
+{
+    m_origin[index] = origin;
+    markDirty(index);
+}
+
+void TransformStore::markDirty(Index index)
+{
+    if(!m_dirty[index])
+    {
+        m_dirty[index] = 1;
+        m_dirtyCount++;
+    }
+}
+
+void TransformStore::update(ThreadPool *pool)
+{
+    if(m_dirtyCount == 0)
+    {
+        return;
+    }
+
+    const std::size_t capacity = getCapacity();
+
+    if(pool && capacity >= minParallelCount)
+    {
+        // Big ranges, so that two threads never write in the same cache line
+        pool->parallelFor(capacity, [this](std::size_t begin, std::size_t end) {
+            computeRange(begin, end);
+        }, 1024);
+    }
+    else
+    {
+        computeRange(0, capacity);
+    }
+
+    m_dirtyCount = 0;
+}
+
+void TransformStore::getMatrix(Index index, glm::mat4& matrix)
+{
+    if(m_dirty[index])
+    {
+        computeOne(index);
+        m_dirty[index] = 0;
+        m_dirtyCount--;
+    }
+
+    // Convert the 2D affine transformation to 3D
+    // | a b c |      | a b 0 c |
+    // | d e f |  =>  | d e 0 f |
+    // | 0 0 1 |      | 0 0 1 0 |
+    //                | 0 0 0 1 |
+    matrix[0] = glm::vec4(m_m00[index], m_m01[index], 0.0f, 0.0f);
+    matrix[1] = glm::vec4(m_m10[index], m_m11[index], 0.0f, 0.0f);
+    matrix[2] = glm::vec4(0.0f, 0.0f, 1.0f, 0.0f);
+    matrix[3] = glm::vec4(m_tx[index], m_ty[index], 0.0f, 1.0f);
+}
+
+void TransformStore::computeRange(std::size_t begin, std::size_t end)
+{
+    for(std::size_t first = begin; first < end; first += blockSize)
+    {
+        // Skip the whole block if no transform is dirty
+        std::uint32_t dirty;
+        static_assert(sizeof(dirty) == blockSize);
+        std::memcpy(&dirty, &m_dirty[first], sizeof(dirty));
+
+        if(dirty)
+        {
+            // Computing the clean transforms of the block again gives the same matrix
+            computeBlock(first);
+            std::memset(&m_dirty[first], 0, blockSize);
+        }
+    }
+}
+
+void TransformStore::computeBlock(std::size_t first)
+{
+#ifdef TRANSFORM_STORE_SSE2
+    __m128 px, py, sx, sy, ox, oy;
+    loadVec2(&m_position[first], px, py);
+    loadVec2(&m_scale[first], sx, sy);
+    loadVec2(&m_origin[first], ox, oy);
+
+    __m128 s, c;
+    sincos(_mm_loadu_ps(&m_rotation[first]), s, c);
+
+    // R*S
+    const __m128 m00 = _mm_mul_ps(c, sx);
+    const __m128 m01 = _mm_mul_ps(s, sx);
+    const __m128 m10 = _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(s, sy));
+    const __m128 m11 = _mm_mul_ps(c, sy);
+
+    // position - R*S*origin
+    const __m128 tx = _mm_sub_ps(px, _mm_add_ps(_mm_mul_ps(m00, ox), _mm_mul_ps(m10, oy)));
+    const __m128 ty = _mm_sub_ps(py, _mm_add_ps(_mm_mul_ps(m01, ox), _mm_mul_ps(m11, oy)));
+
+    _mm_storeu_ps(&m_m00[first], m00);
+    _mm_storeu_ps(&m_m01[first], m01);
+    _mm_storeu_ps(&m_m10[first], m10);
+    _mm_storeu_ps(&m_m11[first], m11);
+    _mm_storeu_ps(&m_tx[first], tx);
+    _mm_storeu_ps(&m_ty[first], ty);
+#else
+    for(std::size_t i = first; i < first + blockSize; ++i)
+    {
+        computeOne(i);
+    }
+#endif
+}
+
+void TransformStore::computeOne(std::size_t index)
+{
+    float s, c;
+    sincos(m_rotation[index], s, c);
+
+    const glm::vec2& scale = m_scale[index];
+    const glm::vec2& origin = m_origin[index];
+    const glm::vec2& position = m_position[index];
+
+    // R*S
+    m_m00[index] = c * scale.x;
+    m_m01[index] = s * scale.x;
+    m_m10[index] = -s * scale.y;
+    m_m11[index] = c * scale.y;
+
+    // position - R*S*origin
+    m_tx[index] = position.x - (m_m00[index] * origin.x + m_m10[index] * origin.y);
+    m_ty[index] = position.y - (m_m01[index] * origin.x + m_m11[index] * origin.y);
+}
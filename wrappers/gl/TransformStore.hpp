@@ -0,0 +1,90 @@
+#pragma once
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+/// @brief Structure of arrays of 2D transforms.
+/// @details
+/// Stores the position, rotation, scale and origin of many transforms in separate arrays, with a dirty flag for each.
+/// update() computes the affine matrices of all the dirty transforms in bulk: the sine and cosine are computed with
+/// a polynomial approximation (no call to std::sin/std::cos), and the matrix is written in closed form without
+/// any intermediate matrix product. With SSE2, four transforms are computed at a time, and the work can be split
+/// across the threads of a ThreadPool.
+/// The matrix is the same as Transformable: T*R*S*T(-origin).
+/// All the Transformable are stored in the global store, but a store can also be used directly to transform
+/// many objects without the overhead of a Transformable for each (e.g. particles).
+/// @remarks Not thread-safe, except update() which is parallelized internally.
+/// Allocating a transform may invalidate the references returned by the getters.
+class TransformStore
+{
+public:
+    using Index = std::uint32_t;
+
+    /// @brief Get the store used by all the Transformable.
+    static TransformStore& getGlobal();
+
+    /// @brief Allocate a transform, with the identity transformation.
+    Index allocate();
+    void release(Index index);
+
+    /// @returns The count of allocated slots, including released ones.
+    std::size_t getCapacity() const;
+
+    /// @name
+    /// @brief Parameters of a transform, see Transformable.
+    /// @{
+
+    const glm::vec2& getPosition(Index index) const;
+    void setPosition(Index index, const glm::vec2& position);
+
+    float getRotation(Index index) const;
+    void setRotation(Index index, float rotation);
+
+    const glm::vec2& getScale(Index index) const;
+    void setScale(Index index, const glm::vec2& scale);
+
+    const glm::vec2& getOrigin(Index index) const;
+    void setOrigin(Index index, const glm::vec2& origin);
+
+    /// @}
+
+    /// @brief Compute the matrices of all the dirty transforms.
+    /// @param pool If not null and there are enough transforms, the work is split across its threads.
+    void update(ThreadPool *pool = nullptr);
+
+    /// @brief Get the matrix of a transform, computing it first if it is dirty.
+    void getMatrix(Index index, glm::mat4& matrix);
+
+private:
+    /// @brief Count of transforms computed at once by the SIMD kernel. The slots are allocated by blocks of this size.
+    static constexpr std::size_t blockSize = 4;
+
+    /// @brief Under this count of transforms, update() is not parallelized.
+    static constexpr std::size_t minParallelCount = 1 << 14;
+
+    void markDirty(Index index);
+
+    /// @brief Compute the dirty matrices in [begin, end), begin and end should be multiples of blockSize.
+    void computeRange(std::size_t begin, std::size_t end);
+    void computeBlock(std::size_t first);
+    void computeOne(std::size_t index);
+
+    // Parameters
+    std::vector<glm::vec2> m_position;
+    std::vector<float> m_rotation;
+    std::vector<glm::vec2> m_scale;
+    std::vector<glm::vec2> m_origin;
+
+    // Affine matrix, GLM column-major: m_m01 is the column 0, row 1
+    std::vector<float> m_m00, m_m01, m_m10, m_m11;
+    std::vector<float> m_tx, m_ty;
+
+    std::vector<std::uint8_t> m_dirty;
+    std::size_t m_dirtyCount{0};
+
+    std::vector<Index> m_free;
+};
@@ -1,12 +1,40 @@
 #include "Transformable.hpp"
-#include <glm/gtx/matrix_transform_2d.hpp>
 
 Transformable::Transformable()
     : m_matrix(1.0f), m_needUpdate(false),
-      m_origin(0.0f), m_position(0.0f), m_scale(1.0f), m_rotation(0.0f)
+      m_index(TransformStore::getGlobal().allocate())
 {
 }
 
+Transformable::~Transformable()
+{
+    if(m_listener)
+    {
+        m_listener->onTransformDestroyed(m_listenerKey);
+    }
+
+    TransformStore::getGlobal().release(m_index);
+}
+
+Transformable::Transformable(const Transformable& rhs)
+    : Transformable()
+{
+    *this = rhs;
+}
+
+Transformable& Transformable::operator=(const Transformable& rhs)
+{
+    if(this != &rhs)
+    {
+        setOrigin(rhs.getOrigin());
+        setPosition(rhs.getPosition());
+        setScale(rhs.getScale());
+        setRotation(rhs.getRotation());
+    }
+
+    return *this;
+}
+
 const glm::mat4& Transformable::getTransform() const
 {
     if(m_needUpdate)
@@ -17,48 +45,70 @@ const glm::mat4& Transformable::getTransform() const
     return m_matrix;
 }
 
-const glm::vec2& Transformable::getOrigin() const
+glm::vec2 Transformable::getOrigin() const
 {
-    return m_origin;
+    return TransformStore::getGlobal().getOrigin(m_index);
 }
 
-const glm::vec2& Transformable::getPosition() const
+glm::vec2 Transformable::getPosition() const
 {
-    return m_position;
+    return TransformStore::getGlobal().getPosition(m_index);
 }
 
-const glm::vec2& Transformable::getScale() const
+glm::vec2 Transformable::getScale() const
 {
-    return m_scale;
+    return TransformStore::getGlobal().getScale(m_index);
 }
 
 float Transformable::getRotation() const
 {
-    return m_rotation;
+    return TransformStore::getGlobal().getRotation(m_index);
 }
 
-void Transformable::setOrigin(const glm::vec2& origin)
+std::uint64_t Transformable::getVersion() const
+{
+    return m_version;
+}
+
+void Transformable::setListener(Listener *listener, std::uint32_t key)
+{
+    m_listener = listener;
+    m_listenerKey = key;
+}
+
+void Transformable::changed()
 {
-    m_origin = origin;
     m_needUpdate = true;
+    ++m_version;
+
+    if(m_listener)
+    {
+        m_listener->onTransformChanged(m_listenerKey);
+    }
+}
+
+void Transformable::setOrigin(const glm::vec2& origin)
+{
+    TransformStore::getGlobal().setOrigin(m_index, origin);
+    changed();
 }
 
 void Transformable::setPosition(const glm::vec2& pos)
 {
-    m_position = pos;
-    m_needUpdate = true;
+    TransformStore::getGlobal().setPosition(m_index, pos);
+    changed();
 }
 
 void Transformable::setScale(const glm::vec2& scale)
 {
-    m_scale = scale;
-    m_needUpdate = true;
+    TransformStore::getGlobal().setScale(m_index, scale);
+    changed();
 }
 
 void Transformable::setRotation(float rotation)
 {
-    m_rotation = rotation;
-    m_needUpdate = true;
+    TransformStore::getGlobal().setRotation(m_index, rotation);
+    changed();
 }
 
 void Transformable::update() const
@@ -69,27 +119,6 @@ void Transformable::update() const
     // S is the scale matrix
     // To is the inverse of the origin translation matrix
 
-    // Since we are in 2D, we just compute the transformation in 2D an then cast to 3D
-    // To optimize, no need to do in 3D
-
-    glm::mat3 matrix(1.0f);
-    matrix = glm::translate(matrix, m_position);
-    matrix = glm::rotate(matrix, m_rotation);
-    matrix = glm::scale(matrix, m_scale);
-    matrix = glm::translate(matrix, -m_origin);
-
-    // Convert 2D transformation to 3D
-    // We can't just copy since there is an extra-row and column inside the matrix
-    // see https://stackoverflow.com/questions/5508424/convert-2d-affine-transformation-matrix-to-3d-affine-transformation-matrix
-
-    // | a b c |      | a b 0 c |
-    // | d e f |  =>  | d e 0 f |
-    // | g h i |      | 0 0 1 0 |
-    //                | g h 0 i |
-
-    // GLM is column-major
-    m_matrix[0] = glm::vec4(matrix[0][0], matrix[0][1], 0.0f, matrix[0][2]);
-    m_matrix[1] = glm::vec4(matrix[1][0], matrix[1][1], 0.0f, matrix[1][2]);
-    m_matrix[2] = glm::vec4(0.0f, 0.0f, 1.0f, 0.0f);
-    m_matrix[3] = glm::vec4(matrix[2][0], matrix[2][1], 0.0f, matrix[2][2]);
+    // The store computes it in closed form, or already computed it if it was updated in bulk
+    TransformStore::getGlobal().getMatrix(m_index, m_matrix);
 }
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "TransformStore.hpp"
 #include <glm/mat4x4.hpp>
+#include <cstdint>
 
 /// @brief Like SFML Transformable.
 /// @details
@@ -8,29 +10,54 @@
 /// The origin is the origin for all other transformations.
 /// The order of transformation is (in local space):
 /// first translation (or position), then rotation, then scale.
+/// The parameters are stored in the global TransformStore, so the matrices of all the Transformable can be
+/// computed in bulk with TransformStore::getGlobal().update(), for example once per frame before drawing.
+/// Otherwise, the matrix is computed on demand by getTransform(), like before.
 class Transformable
 {
 public:
+    /// @brief Notified when a Transformable is modified, for example to update a spatial index incrementally.
+    /// @details A raw interface rather than a signal, to keep the Transformable small when there are millions of them.
+    class Listener
+    {
+    public:
+        virtual ~Listener() = default;
+
+        /// @brief Called by each setter.
+        /// @param key The key given to setListener(), to identify the Transformable.
+        virtual void onTransformChanged(std::uint32_t key) = 0;
+
+        /// @brief Called by the destructor, the Transformable should not be used anymore.
+        virtual void onTransformDestroyed(std::uint32_t key) = 0;
+    };
+
     Transformable();
-    virtual ~Transformable() = default;
+    virtual ~Transformable();
+
+    Transformable(const Transformable& rhs);
+    Transformable& operator=(const Transformable& rhs);
 
+    /// @remarks Although const, the matrix is computed in the global TransformStore if a parameter changed since the
+    /// previous call, so like the setters it must not be called concurrently with other Transformable.
     const glm::mat4& getTransform() const;
 
     /// @details
+    /// The parameters are returned by value: they live in the global TransformStore, whose arrays are reallocated
+    /// when another Transformable is constructed.
     /// The origin is without any transformation applied. When rendered in the world,
     /// the origin will always be rendered on the world coordinates where the object is rendered.
     /// The default origin is (0, 0).
-    const glm::vec2& getOrigin() const;
+    glm::vec2 getOrigin() const;
     void setOrigin(const glm::vec2& origin);
 
     /// @details
     /// The default position is (0, 0).
-    const glm::vec2& getPosition() const;
+    glm::vec2 getPosition() const;
     void setPosition(const glm::vec2& pos);
 
     /// @details
     /// The default scale is (1, 1).
-    const glm::vec2& getScale() const;
+    glm::vec2 getScale() const;
     void setScale(const glm::vec2& scale);
 
     /// @details
@@ -39,7 +66,18 @@ public:
     void setRotation(float rotation);
     float getRotation() const;
 
+    /// @brief Incremented by each setter, so that anything computed from the transform can be cached.
+    /// @details Unlike the matrix, a value is never reset, so any number of caches can compare it.
+    std::uint64_t getVersion() const;
+
+    /// @brief Set the object to notify when this is modified, nullptr for none. There is a single listener.
+    /// @remarks The listener is not copied with the Transformable.
+    void setListener(Listener *listener, std::uint32_t key = 0);
+
 private:
+    /// @brief A parameter changed.
+    void changed();
+
     /// @brief Update the matrix based on parameters. Const to allow to be called from getTransform().
     void update() const;
 
@@ -48,9 +86,11 @@ private:
     mutable glm::mat4 m_matrix;
     mutable bool m_needUpdate;
 
-    glm::vec2 m_origin{};
-    glm::vec2 m_position{};
-    glm::vec2 m_scale{};
-    float m_rotation{};
-};
+    std::uint64_t m_version{0};
+
+    Listener *m_listener{nullptr};
+    std::uint32_t m_listenerKey{0};
 
+    /// @brief The slot of the parameters in the global store.
+    TransformStore::Index m_index;
+};
\ No newline at end of file
@@ -0,0 +1,321 @@
+#include "Triangulation.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+namespace
+{
+    /// @returns Twice the signed area of the triangle abc, positive if counter-clockwise.
+    float cross(const glm::vec2& a, const glm::vec2& b, const glm::vec2& c)
+    {
+        return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    }
+
+    /// @brief Uniform grid of the reflex vertices.
+    /// @details The vertices are removed when they become convex, so the cells only contain the vertices that can
+    /// still be inside an ear.
+    class ReflexGrid
+    {
+    public:
+        ReflexGrid(std::span<const Vertex> polygon, const std::vector<std::uint8_t>& reflex)
+            : m_polygon(polygon)
+        {
+            const std::size_t reflexCount = static_cast<std::size_t>(std::count(reflex.begin(), reflex.end(), 1));
+
+            m_min = m_max = polygon[0].pos;
+
+            for(const Vertex& vertex : polygon)
+            {
+                m_min = glm::min(m_min, vertex.pos);
+                m_max = glm::max(m_max, vertex.pos);
+            }
+
+            // The vertices are along the border, not uniformly distributed, so there are more cells than vertices
+            m_side = std::max<std::size_t>(1, static_cast<std::size_t>(2.0f * std::sqrt(static_cast<float>(reflexCount))));
+            m_cellSize = glm::max((m_max - m_min) / static_cast<float>(m_side), glm::vec2{1e-20f});
+
+            // Compressed storage: count the vertices of each cell, then the start of a cell is the sum before it
+            m_cells.assign(m_side * m_side + 1, 0);
+
+            for(std::size_t i = 0; i < polygon.size(); ++i)
+            {
+                if(reflex[i])
+                {
+                    m_cells[getCell(polygon[i].pos) + 1]++;
+                }
+            }
+
+            std::partial_sum(m_cells.begin(), m_cells.end(), m_cells.begin());
+            m_vertices.resize(reflexCount);
+            m_slots.resize(polygon.size());
+
+            // Filled from the start of each cell, so at the end it is the end of each cell
+            m_ends.assign(m_cells.begin(), m_cells.end() - 1);
+
+            for(std::size_t i = 0; i < polygon.size(); ++i)
+            {
+                if(reflex[i])
+                {
+                    const std::uint32_t slot = m_ends[getCell(polygon[i].pos)]++;
+                    m_vertices[slot] = static_cast<std::uint32_t>(i);
+                    m_slots[i] = slot;
+                }
+            }
+        }
+
+        /// @brief Remove a vertex of the grid, in constant time.
+        void remove(std::uint32_t index)
+        {
+            // Swap with the last vertex of the cell
+            const std::uint32_t last = --m_ends[getCell(m_polygon[index].pos)];
+            const std::uint32_t slot = m_slots[index];
+            const std::uint32_t moved = m_vertices[last];
+
+            m_vertices[slot] = moved;
+            m_slots[moved] = slot;
+        }
+
+        /// @brief Call func(index) for each vertex in the cells overlapping the triangle abc, until it returns true.
+        /// @returns true if func returned true.
+        template<typename Func>
+        bool any(const glm::vec2& a, const glm::vec2& b, const glm::vec2& c, const Func& func) const
+        {
+            const float minY = std::min({a.y, b.y, c.y});
+            const float maxY = std::max({a.y, b.y, c.y});
+
+            const std::size_t y0 = getCoordinate(minY, 1), y1 = getCoordinate(maxY, 1);
+
+            for(std::size_t y = y0; y <= y1; ++y)
+            {
+                // Only the cells of the row under the triangle, thin diagonal triangles have a big bounding box
+                const float rowMin = std::max(minY, m_min.y + static_cast<float>(y) * m_cellSize.y);
+                const float rowMax = std::min(maxY, m_min.y + static_cast<float>(y + 1) * m_cellSize.y);
+
+                float minX = std::numeric_limits<float>::max();
+                float maxX = std::numeric_limits<float>::lowest();
+
+                for(const auto& [p, q] : {std::pair{a, b}, std::pair{b, c}, std::pair{c, a}})
+                {
+                    clipEdge(p, q, rowMin, rowMax, minX, maxX);
+                }
+
+                if(minX > maxX)
+                {
+                    continue;
+                }
+
+                const std::size_t x0 = getCoordinate(minX, 0), x1 = getCoordinate(maxX, 0);
+
+                for(std::size_t x = x0; x <= x1; ++x)
+                {
+                    const std::size_t cell = y * m_side + x;
+
+                    for(std::uint32_t i = m_cells[cell]; i < m_ends[cell]; ++i)
+                    {
+                        if(func(m_vertices[i]))
+                        {
+                            return true;
+                        }
+                    }
+                }
+            }
+
+            return false;
+        }
+
+    private:
+        /// @brief Extend [minX, maxX] by the x range of the part of the edge pq in the row [rowMin, rowMax].
+        static void clipEdge(const glm::vec2& p, const glm::vec2& q, float rowMin, float rowMax, float& minX, float& maxX)
+        {
+            const float low = std::max(std::min(p.y, q.y), rowMin);
+            const float high = std::min(std::max(p.y, q.y), rowMax);
+
+            if(low > high)
+            {
+                return;
+            }
+
+            // x on the edge at a height, the edge is a point if horizontal
+            auto at = [&](float y) {
+                return p.y == q.y ? p.x : p.x + (q.x - p.x) * (y - p.y) / (q.y - p.y);
+            };
+
+            if(p.y == q.y)
+            {
+                minX = std::min({minX, p.x, q.x});
+                maxX = std::max({maxX, p.x, q.x});
+            }
+            else
+            {
+                const float x0 = at(low), x1 = at(high);
+                minX = std::min({minX, x0, x1});
+                maxX = std::max({maxX, x0, x1});
+            }
+        }
+
+        std::size_t getCoordinate(float value, int axis) const
+        {
+            const float cell = std::floor((value - m_min[axis]) / m_cellSize[axis]);
+            return static_cast<std::size_t>(std::clamp(cell, 0.0f, static_cast<float>(m_side - 1)));
+        }
+
+        std::size_t getCell(const glm::vec2& pos) const
+        {
+            return getCoordinate(pos.y, 1) * m_side + getCoordinate(pos.x, 0);
+        }
+
+        std::span<const Vertex> m_polygon;
+
+        glm::vec2 m_min, m_max, m_cellSize;
+        std::size_t m_side;
+
+        // The vertices of the cell i are in m_vertices[m_cells[i], m_ends[i])
+        std::vector<std::uint32_t> m_cells;
+        std::vector<std::uint32_t> m_ends;
+        std::vector<std::uint32_t> m_vertices;
+        std::vector<std::uint32_t> m_slots; ///< Index of each vertex in m_vertices.
+    };
+}
+
+bool Triangulation::isConvex(std::span<const Vertex> polygon)
+{
+    const std::size_t size = polygon.size();
+    bool positive = false, negative = false;
+
+    for(std::size_t i = 0; i < size; ++i)
+    {
+        const float turn = cross(polygon[i].pos, polygon[(i + 1) % size].pos, polygon[(i + 2) % size].pos);
+
+        positive = positive || turn > 0.0f;
+        negative = negative || turn < 0.0f;
+    }
+
+    return !(positive && negative);
+}
+
+void Triangulation::triangulate(std::span<const Vertex> polygon, std::vector<std::uint32_t>& indices)
+{
+    indices.clear();
+
+    const std::size_t size = polygon.size();
+
+    if(size < 3)
+    {
+        return;
+    }
+
+    indices.reserve((size - 2) * 3);
+
+    // Same computations for clockwise polygons, with the signs inverted
+    float area = 0.0f;
+
+    for(std::size_t i = 0; i < size; ++i)
+    {
+        const glm::vec2& a = polygon[i].pos;
+        const glm::vec2& b = polygon[(i + 1) % size].pos;
+        area += a.x * b.y - b.x * a.y;
+    }
+
+    const float orientation = area < 0.0f ? -1.0f : 1.0f;
+
+    // Remaining polygon, as a circular doubly linked list
+    std::vector<std::uint32_t> prev(size), next(size);
+
+    for(std::size_t i = 0; i < size; ++i)
+    {
+        prev[i] = static_cast<std::uint32_t>((i + size - 1) % size);
+        next[i] = static_cast<std::uint32_t>((i + 1) % size);
+    }
+
+    auto turn = [&](std::uint32_t i) {
+        return cross(polygon[prev[i]].pos, polygon[i].pos, polygon[next[i]].pos) * orientation;
+    };
+
+    std::vector<std::uint8_t> reflex(size);
+
+    for(std::uint32_t i = 0; i < size; ++i)
+    {
+        reflex[i] = turn(i) < 0.0f;
+    }
+
+    ReflexGrid grid(polygon, reflex);
+
+    auto isEar = [&](std::uint32_t i) {
+        const std::uint32_t ia = prev[i], ic = next[i];
+        const glm::vec2& a = polygon[ia].pos;
+        const glm::vec2& b = polygon[i].pos;
+        const glm::vec2& c = polygon[ic].pos;
+
+        return !grid.any(a, b, c, [&](std::uint32_t j) {
+            const glm::vec2& p = polygon[j].pos;
+
+            // Duplicated vertices do not block the ear
+            if(j == ia || j == i || j == ic || p == a || p == b || p == c)
+            {
+                return false;
+            }
+
+            // Inside or on an edge
+            return cross(a, b, p) * orientation >= 0.0f && cross(b, c, p) * orientation >= 0.0f
+                && cross(c, a, p) * orientation >= 0.0f;
+        });
+    };
+
+    std::size_t remaining = size;
+    std::uint32_t current = 0;
+    std::uint32_t stop = current; // If the whole polygon was walked without finding an ear
+
+    while(remaining > 3)
+    {
+        const float currentTurn = turn(current);
+
+        if(currentTurn >= 0.0f && (currentTurn == 0.0f || isEar(current)))
+        {
+            const std::uint32_t a = prev[current], c = next[current];
+
+            // A collinear vertex is removed without a triangle
+            if(currentTurn > 0.0f)
+            {
+                indices.insert(indices.end(), {a, current, c});
+            }
+
+            next[a] = c;
+            prev[c] = a;
+            remaining--;
+
+            // Clipping an ear can only make its neighbours convex
+            for(std::uint32_t neighbour : {a, c})
+            {
+                if(reflex[neighbour] && turn(neighbour) >= 0.0f)
+                {
+                    reflex[neighbour] = false;
+                    grid.remove(neighbour);
+                }
+            }
+
+            // Continue after the next vertex, clipping from c again would create a fan of long thin triangles,
+            // which are slow to test with the grid
+            current = next[c];
+            stop = current;
+        }
+        else
+        {
+            current = next[current];
+
+            if(current == stop)
+            {
+                // Not a simple polygon: fill the rest as a fan
+                for(std::uint32_t i = next[next[current]]; i != current; i = next[i])
+                {
+                    indices.insert(indices.end(), {current, prev[i], i});
+                }
+
+                return;
+            }
+        }
+    }
+
+    indices.insert(indices.end(), {prev[current], current, next[current]});
+}
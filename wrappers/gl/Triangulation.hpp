@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Vertex.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// @brief Triangulation of simple polygons, to fill the concave shapes.
+/// @details
+/// Ear clipping: a vertex is an ear if it is convex and no other vertex is inside the triangle formed with its two
+/// neighbours. Then the triangle can be removed from the polygon. Only the reflex vertices can be inside an ear,
+/// so they are stored in a uniform grid, and the test of an ear only looks at the cells under the triangle.
+/// For usual polygons, each ear test is in constant time and the triangulation is close to linear.
+namespace Triangulation
+{
+    /// @returns true if all the turns of the polygon are in the same direction, so that it can be drawn as a fan.
+    /// @remarks Collinear vertices are ignored.
+    bool isConvex(std::span<const Vertex> polygon);
+
+    /// @brief Triangulate a simple polygon, clockwise or counter-clockwise.
+    /// @param indices Replaced by the indices of the triangles, to be drawn with GL_TRIANGLES.
+    /// @details If the polygon is not simple (it intersects itself), the remaining part that cannot be triangulated
+    /// is filled as a fan.
+    void triangulate(std::span<const Vertex> polygon, std::vector<std::uint32_t>& indices);
+}
@@ -1,9 +1,77 @@
 #include "Vertex.hpp"
 #include "GL.hpp"
+#include <glm/gtc/packing.hpp>
+#include <cstring>
 
-void Vertex::vertexAttribPointer()
+void Vertex::vertexAttribPointer(Format format)
 {
-    GL::vertexAttribPointer(Vertex::Position, 2, GL_FLOAT, &Vertex::pos);
-    GL::vertexAttribPointer(Vertex::Color, 4, GL_FLOAT, &Vertex::color);
-    GL::vertexAttribPointer(Vertex::TexCoords, 2, GL_FLOAT, &Vertex::uv);
+    switch(format)
+    {
+        case Format::Full:
+            GL::vertexAttribPointer(Vertex::Position, 2, GL_FLOAT, &Vertex::pos);
+            GL::vertexAttribPointer(Vertex::Color, 4, GL_FLOAT, &Vertex::color);
+            GL::vertexAttribPointer(Vertex::TexCoords, 2, GL_FLOAT, &Vertex::uv);
+            break;
+
+        case Format::Packed:
+            GL::vertexAttribPointer(Vertex::Position, 2, GL_FLOAT, &PackedVertex::pos);
+            GL::vertexAttribPointer(Vertex::Color, 4, GL_UNSIGNED_BYTE, &PackedVertex::color, GL_TRUE);
+            GL::vertexAttribPointer(Vertex::TexCoords, 2, GL_FLOAT, &PackedVertex::uv);
+            break;
+
+        case Format::Compact:
+            GL::vertexAttribPointer(Vertex::Position, 2, GL_FLOAT, &CompactVertex::pos);
+            GL::vertexAttribPointer(Vertex::Color, 4, GL_UNSIGNED_BYTE, &CompactVertex::color, GL_TRUE);
+            GL::vertexAttribPointer(Vertex::TexCoords, 2, GL_HALF_FLOAT, &CompactVertex::uv);
+            break;
+    }
+}
+
+std::size_t Vertex::getSize(Format format)
+{
+    switch(format)
+    {
+        case Format::Packed: return sizeof(PackedVertex);
+        case Format::Compact: return sizeof(CompactVertex);
+        default: return sizeof(Vertex);
+    }
+}
+
+void Vertex::pack(std::span<const Vertex> vertices, Format format, std::vector<unsigned char>& buffer)
+{
+    buffer.resize(vertices.size() * getSize(format));
+    pack(vertices, format, buffer.data());
+}
+
+void Vertex::pack(std::span<const Vertex> vertices, Format format, void *destination)
+{
+    // packUnorm4x8() is little-endian, so the bytes are in RGBA order like GL_UNSIGNED_BYTE expects
+    switch(format)
+    {
+        case Format::Full:
+            std::memcpy(destination, vertices.data(), vertices.size_bytes());
+            break;
+
+        case Format::Packed:
+        {
+            auto *packed = static_cast<PackedVertex*>(destination);
+
+            for(const Vertex& vertex : vertices)
+            {
+                *packed++ = {vertex.pos, glm::packUnorm4x8(vertex.color), vertex.uv};
+            }
+            break;
+        }
+
+        case Format::Compact:
+        {
+            auto *compact = static_cast<CompactVertex*>(destination);
+
+            for(const Vertex& vertex : vertices)
+            {
+                *compact++ = {vertex.pos, glm::packUnorm4x8(vertex.color), glm::packHalf2x16(vertex.uv)};
+            }
+            break;
+        }
+    }
 }
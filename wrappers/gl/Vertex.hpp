@@ -2,6 +2,9 @@
 
 #include <glm/vec2.hpp>
 #include <glm/vec4.hpp>
+#include <cstdint>
+#include <span>
+#include <vector>
 
 struct Vertex
 {
@@ -12,6 +15,15 @@ struct Vertex
         TexCoords = 2, ///< uv
     };
 
+    /// @brief Layout of the vertices in a GPU buffer.
+    /// @details The vertices are always manipulated as Vertex on the CPU, and converted when uploaded.
+    /// The shaders are the same for all the formats, since the packed attributes are converted by OpenGL.
+    enum class Format {
+        Full, ///< Vertex, 32 bytes.
+        Packed, ///< PackedVertex, 20 bytes. The color is RGBA8, clamped to [0, 1].
+        Compact, ///< CompactVertex, 16 bytes. The color is RGBA8 and the UVs are half-precision floats.
+    };
+
     Vertex() = default;
     Vertex(const glm::vec2& pos) : pos(pos) {}
     Vertex(const glm::vec2& pos, const glm::vec4& color) : pos(pos), color(color) {}
@@ -20,6 +32,36 @@ struct Vertex
     glm::vec4 color{1.0f};
     glm::vec2 uv{0.0f};
 
+    bool operator==(const Vertex& rhs) const = default;
+
     /// @brief Setup the attributes with glVertexAttribPointer() for the currently bound VAO.
-    static void vertexAttribPointer();
+    static void vertexAttribPointer(Format format = Format::Full);
+
+    /// @returns The size of a vertex in the format, in bytes.
+    static std::size_t getSize(Format format);
+
+    /// @brief Convert the vertices to a format.
+    /// @param buffer Replaced by the vertices in the format, ready to be uploaded.
+    static void pack(std::span<const Vertex> vertices, Format format, std::vector<unsigned char>& buffer);
+
+    /// @brief Convert the vertices to a format.
+    /// @param destination Where to write the vertices, at least vertices.size() * getSize(format) bytes.
+    /// It can be mapped GPU memory, it is only written sequentially.
+    static void pack(std::span<const Vertex> vertices, Format format, void *destination);
+};
+
+/// @brief Vertex with a normalized RGBA8 color.
+struct PackedVertex
+{
+    glm::vec2 pos;
+    std::uint32_t color;
+    glm::vec2 uv;
+};
+
+/// @brief Vertex with a normalized RGBA8 color and half-precision UVs.
+struct CompactVertex
+{
+    glm::vec2 pos;
+    std::uint32_t color;
+    std::uint32_t uv;
 };
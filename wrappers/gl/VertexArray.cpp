@@ -1,4 +1,7 @@
 #include "VertexArray.hpp"
+#include "Indices.hpp"
+#include "Renderer.hpp"
+#include "StreamBuffer.hpp"
 #include <glm/gtc/matrix_transform.hpp>
 #include <cstddef>
 
@@ -11,24 +14,33 @@ void VertexArray::setTexture(const Texture *texture)
 
 void VertexArray::setVertices(const std::vector<Vertex>& vertices)
 {
-    m_verticesCount = static_cast<int>(vertices.size());
+    DirtyRange modified;
+    modified.addChanges<Vertex>(m_vertices, vertices);
 
-    auto stride = static_cast<GLsizei>(sizeof(vertices[0]));
-    auto nBytes = static_cast<GLsizeiptr>(vertices.size() * stride);
+    m_vertices = vertices;
+    m_verticesCount = static_cast<int>(vertices.size());
 
-    glBindVertexArray(m_vao);
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    m_localBounds = Bounds::compute(m_vertices);
+    m_globalBounds.invalidate();
 
-    glBufferData(GL_ARRAY_BUFFER, nBytes, vertices.data(), m_usage);
+    if(m_dynamic)
+    {
+        // Streamed when drawn
+        return;
+    }
 
-    glVertexAttribPointer(POSITION, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(offsetof(Vertex, pos)));
-    glEnableVertexAttribArray(POSITION);
+    m_buffer.setFormat(m_vertexFormat);
+    m_buffer.update(m_vertices, modified);
+}
 
-    glVertexAttribPointer(COLOR, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(offsetof(Vertex, color)));
-    glEnableVertexAttribArray(COLOR);
+void VertexArray::setIndices(const std::vector<std::uint32_t>& indices)
+{
+    m_indices = indices;
 
-    glVertexAttribPointer(UV, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(offsetof(Vertex, uv)));
-    glEnableVertexAttribArray(UV);
+    if(!m_dynamic)
+    {
+        m_buffer.setIndices(m_indices);
+    }
 }
 
 void VertexArray::setPrimitiveType(GLenum type)
@@ -36,10 +48,39 @@ void VertexArray::setPrimitiveType(GLenum type)
     m_primitive = type;
 }
 
+const Rect& VertexArray::getLocalBounds() const
+{
+    return m_localBounds;
+}
+
+const Rect& VertexArray::getGlobalBounds() const
+{
+    return m_globalBounds.get(*this, m_localBounds);
+}
+
 void VertexArray::draw(RenderStates states) const
 {
+    if(!Bounds::isVisible(states, getGlobalBounds()))
+    {
+        return;
+    }
+
     states.model *= getTransform();
 
+    if(states.renderer)
+    {
+        if(m_indices.empty())
+        {
+            states.renderer->draw(states, m_texture, m_primitive, m_vertices);
+        }
+        else
+        {
+            states.renderer->draw(states, m_texture, m_primitive, m_vertices, m_indices);
+        }
+
+        return;
+    }
+
     if(states.shader)
     {
         Shader::bind(states.shader);
@@ -51,11 +92,57 @@ void VertexArray::draw(RenderStates states) const
 
     Texture::bind(m_texture);
 
-    glBindVertexArray(m_vao);
-    glDrawArrays(m_primitive, 0, m_verticesCount);
+    if(m_dynamic)
+    {
+        StreamBuffer& stream = StreamBuffer::getGlobal();
+
+        if(m_indices.empty())
+        {
+            const GLint first = stream.write(m_vertices, m_vertexFormat);
+
+            stream.bindVertexArray(m_vertexFormat);
+            glDrawArrays(m_primitive, first, m_verticesCount);
+        }
+        else
+        {
+            const GLenum type = Indices::getType(m_vertices.size());
+            const StreamBuffer::IndexedGeometry geometry = stream.write(m_vertices, m_vertexFormat, m_indices, type);
+
+            stream.bindVertexArray(m_vertexFormat);
+            glDrawElementsBaseVertex(m_primitive, static_cast<GLsizei>(m_indices.size()), type,
+                                     reinterpret_cast<const void*>(geometry.indices), geometry.first);
+        }
+    }
+    else
+    {
+        m_buffer.draw(m_primitive);
+    }
 }
 
 void VertexArray::setUsage(GLenum usage)
 {
-    m_usage = usage;
+    m_buffer.setUsage(usage);
+}
+
+void VertexArray::setDynamic(bool dynamic)
+{
+    if(m_dynamic && !dynamic)
+    {
+        // The buffer was not updated while the vertices were streamed
+        m_buffer.setFormat(m_vertexFormat);
+        m_buffer.update(m_vertices);
+        m_buffer.setIndices(m_indices);
+    }
+
+    m_dynamic = dynamic;
+}
+
+bool VertexArray::isDynamic() const
+{
+    return m_dynamic;
+}
+
+void VertexArray::setVertexFormat(Vertex::Format format)
+{
+    m_vertexFormat = format;
 }
\ No newline at end of file
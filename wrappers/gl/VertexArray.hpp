@@ -1,11 +1,14 @@
 #pragma once
 
+#include "Bounds.hpp"
 #include "Vertex.hpp"
 #include "Drawable.hpp"
 #include "Texture.hpp"
 #include "Transformable.hpp"
+#include "VertexBuffer.hpp"
 #include <wrappers/gl/GL.hpp>
 #include <glm/glm.hpp>
+#include <cstdint>
 #include <vector>
 #include <type_traits>
 
@@ -25,6 +28,16 @@ public:
     /// @remarks The usage will only be updated when the vertices will be reconstructed, that is when the next setVertices() call will be done.
     void setUsage(GLenum usage);
 
+    /// @brief If the vertices change often. The default is false.
+    /// @details A dynamic VertexArray does not upload its vertices in setVertices(), they are written in the global
+    /// StreamBuffer each time it is drawn.
+    void setDynamic(bool dynamic);
+    bool isDynamic() const;
+
+    /// @brief Set the layout of the vertices in the GPU buffer. Full by default.
+    /// @remarks Like the usage, the format will only be updated at the next setVertices() call.
+    void setVertexFormat(Vertex::Format format);
+
     void draw(RenderStates states) const override;
 
     /// @brief Each attribute should have it's location as it (type corresponding in Vertex class)
@@ -34,17 +47,33 @@ public:
         UV = 2,
     };
 
+    /// @details If the count of vertices did not change, only the range of modified vertices is uploaded.
     void setVertices(const std::vector<Vertex>& vertices);
 
+    /// @brief Set the indices of the vertices to draw, in the primitive type.
+    /// @details Optional, if empty (the default) all the vertices are drawn in order.
+    /// The indices are uploaded as 16-bit if all the vertices can be addressed with 16 bits.
+    void setIndices(const std::vector<std::uint32_t>& indices);
+
+    /// @brief Get the bounding box of the vertices, without the transformation.
+    const Rect& getLocalBounds() const;
+
+    /// @brief Get the bounding box in the space of the parent, with the transformation.
+    const Rect& getGlobalBounds() const;
+
     /// @param type Should be one of https://www.khronos.org/opengl/wiki/Primitive (GL_TRIANGLES, GL_LINES, etc...)
     void setPrimitiveType(GLenum type);
 
 private:
-    GL::VertexArray m_vao;
-    GL::Buffer m_vbo;
+    VertexBuffer m_buffer;
     GLenum m_primitive = GL_LINES;
     int m_verticesCount = 0;
+    std::vector<Vertex> m_vertices; ///< CPU copy of the vertices, to be submitted to a Renderer.
+    std::vector<std::uint32_t> m_indices; ///< CPU copy of the indices, empty if not indexed.
+    Rect m_localBounds;
+    GlobalBounds m_globalBounds;
     const Texture *m_texture = nullptr;
-    GLenum m_usage = GL_STATIC_DRAW;
+    Vertex::Format m_vertexFormat = Vertex::Format::Full;
+    bool m_dynamic = false;
 };
 
@@ -0,0 +1,127 @@
+#include "VertexBuffer.hpp"
+#include "Indices.hpp"
+#include <algorithm>
+
+void VertexBuffer::setFormat(Vertex::Format format)
+{
+    if(m_format != format)
+    {
+        m_format = format;
+        m_attributesReady = false;
+    }
+}
+
+Vertex::Format VertexBuffer::getFormat() const
+{
+    return m_format;
+}
+
+void VertexBuffer::setUsage(GLenum usage)
+{
+    m_usage = usage;
+}
+
+void VertexBuffer::update(std::span<const Vertex> vertices)
+{
+    update(vertices, DirtyRange{0, vertices.size()});
+}
+
+void VertexBuffer::update(std::span<const Vertex> vertices, const DirtyRange& range)
+{
+    const std::size_t stride = Vertex::getSize(m_format);
+    const std::size_t size = vertices.size() * stride;
+
+    DirtyRange upload = range;
+    upload.end = std::min(upload.end, vertices.size());
+
+    // The previous content is not valid anymore
+    if(vertices.size() != m_count || !m_attributesReady)
+    {
+        upload = {0, vertices.size()};
+    }
+
+    m_count = vertices.size();
+
+    GL::bindVertexArray(m_vao);
+    GL::bindBuffer(GL_ARRAY_BUFFER, m_vbo);
+
+    if(size > m_capacity)
+    {
+        // Grow geometrically so that a vertex count growing a little at a time does not reallocate each time
+        m_capacity = std::max(size, m_capacity * 2);
+        GL::bufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_capacity), nullptr, m_usage);
+
+        upload = {0, vertices.size()};
+    }
+
+    if(!m_attributesReady)
+    {
+        m_attributesReady = true;
+        Vertex::vertexAttribPointer(m_format);
+    }
+
+    if(!upload.empty())
+    {
+        Vertex::pack(vertices.subspan(upload.begin, upload.end - upload.begin), m_format, m_packed);
+
+        GL::bufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(upload.begin * stride),
+                          static_cast<GLsizeiptr>(m_packed.size()), m_packed.data());
+    }
+}
+
+void VertexBuffer::setIndices(std::span<const std::uint32_t> indices)
+{
+    m_indexCount = indices.size();
+
+    if(indices.empty())
+    {
+        return;
+    }
+
+    const std::uint32_t maxIndex = *std::max_element(indices.begin(), indices.end());
+    m_indexType = Indices::getType(std::size_t{maxIndex} + 1);
+    Indices::pack(indices, m_indexType, m_packedIndices);
+
+    // The element buffer binding is part of the VAO state
+    GL::bindVertexArray(m_vao);
+    GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+
+    const std::size_t size = m_packedIndices.size();
+
+    if(size > m_indexCapacity)
+    {
+        m_indexCapacity = std::max(size, m_indexCapacity * 2);
+        GL::bufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_indexCapacity), nullptr, m_usage);
+    }
+
+    GL::bufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(size), m_packedIndices.data());
+}
+
+bool VertexBuffer::isIndexed() const
+{
+    return m_indexCount > 0;
+}
+
+void VertexBuffer::bind() const
+{
+    GL::bindVertexArray(m_vao);
+}
+
+void VertexBuffer::draw(GLenum primitive) const
+{
+    bind();
+
+    if(isIndexed())
+    {
+        glDrawElements(primitive, static_cast<GLsizei>(m_indexCount), m_indexType, nullptr);
+    }
+    else
+    {
+        glDrawArrays(primitive, 0, static_cast<GLsizei>(m_count));
+    }
+}
+
+std::size_t VertexBuffer::getCount() const
+{
+    return m_count;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "GL.hpp"
+#include "Vertex.hpp"
+#include <utility/DirtyRange.hpp>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// @brief A VAO with its own vertex buffer, updated in place.
+/// @details
+/// The storage of the buffer only grows, geometrically, so that glBufferData() is only called when the vertices
+/// do not fit anymore. Otherwise, only the modified vertices are uploaded with glBufferSubData().
+/// The attributes of the VAO are set up once, and again only if the format changes.
+/// It can also have an element buffer, in this case draw() uses glDrawElements().
+class VertexBuffer
+{
+public:
+    /// @brief Set the layout of the vertices in the buffer. Full by default.
+    /// @details All the vertices will be uploaded at the next update.
+    void setFormat(Vertex::Format format);
+    Vertex::Format getFormat() const;
+
+    /// @brief Parameter usage to glBufferData(). GL_STATIC_DRAW by default.
+    /// @remarks Only used when the storage grows.
+    void setUsage(GLenum usage);
+
+    /// @brief Upload the modified vertices.
+    /// @param range The vertices modified since the last update. Ignored if the count of vertices changed, in this
+    /// case all the vertices are uploaded.
+    void update(std::span<const Vertex> vertices, const DirtyRange& range);
+
+    /// @brief Upload all the vertices.
+    void update(std::span<const Vertex> vertices);
+
+    /// @brief Set the indices of the element buffer.
+    /// @details They are uploaded as 16-bit indices if possible. An empty span removes the element buffer.
+    void setIndices(std::span<const std::uint32_t> indices);
+
+    /// @returns true if there is an element buffer.
+    bool isIndexed() const;
+
+    /// @brief Bind the VAO.
+    void bind() const;
+
+    /// @brief Bind the VAO and draw all the vertices, or all the indices if there is an element buffer.
+    void draw(GLenum primitive) const;
+
+    std::size_t getCount() const;
+
+private:
+    GL::VertexArray m_vao;
+    GL::Buffer m_vbo;
+
+    std::size_t m_capacity{0}; ///< Size of the storage, in bytes.
+    std::size_t m_count{0}; ///< Count of vertices in the buffer.
+
+    Vertex::Format m_format{Vertex::Format::Full};
+    GLenum m_usage{GL_STATIC_DRAW};
+    bool m_attributesReady{false}; ///< If the attributes of the VAO match the format.
+
+    std::vector<unsigned char> m_packed; ///< The uploaded vertices converted to the format.
+
+    GL::Buffer m_ebo;
+    std::size_t m_indexCapacity{0}; ///< Size of the element buffer storage, in bytes.
+    std::size_t m_indexCount{0};
+    GLenum m_indexType{GL_UNSIGNED_SHORT};
+    std::vector<unsigned char> m_packedIndices;
+};